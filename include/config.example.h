@@ -37,13 +37,21 @@
 // 0=portrait, 1=landscape, 2=portrait inverted, 3=landscape inverted
 #define TFT_ROTATION 3
 
-// ---- Favorite country (NOC code) ----
-// Example: "CAN", "USA", "NOR"
-#define FOCUS_TEAM_ABBR "CAN"
+// ---- Favorite countries (NOC codes) ----
+// Up to 5, comma separated. Example: "CAN", "CAN,USA,NOR"
+#ifndef FOCUS_TEAM_ABBRS
+#define FOCUS_TEAM_ABBRS "CAN"
+#endif
 
 // ---- Poll intervals (ms) ----
 #define POLL_SCOREBOARD_MS   15000   // 15s
 #define POLL_GAMEDETAIL_MS    8000   // 8s (only when a game is live)
+
+// 1 = poll intervals follow the day's schedule (15s to 5 min for medals);
+// 0 = fixed 30s medals / 60s schedule.
+#ifndef ADAPTIVE_POLLING
+#define ADAPTIVE_POLLING 1
+#endif
 
 // Optional SD access (disabled in esp32-cyd-sdfix).
 #ifndef ENABLE_SD_LOGOS
@@ -0,0 +1,352 @@
+#pragma once
+
+// Host-side stand-in for the parts of the Arduino-ESP32 core the portable
+// modules use. Only built by the `native` PlatformIO env.
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(s) (s)
+#define SET_LOOP_TASK_STACK_SIZE(sz)
+
+namespace NativeClock {
+
+// A simulator may take over time: micros() then reads a virtual clock that
+// only moves when a task sleeps, and xTaskCreatePinnedToCore() hands new tasks
+// to it instead of starting threads.
+class Scheduler {
+public:
+  virtual ~Scheduler() {}
+  virtual uint64_t nowUs() = 0;
+  virtual void sleepUs(uint64_t us) = 0;
+  virtual void spawn(void (*fn)(void *), void *arg) = 0;
+  // One pointer of per-task storage for the running task, and a way to end
+  // the sleep of the task whose storage holds `local`.
+  virtual void *&taskLocal() = 0;
+  virtual void wake(void *local) = 0;
+};
+
+inline Scheduler *&scheduler() {
+  static Scheduler *active = nullptr;
+  return active;
+}
+
+inline std::chrono::steady_clock::time_point start() {
+  static const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  return t0;
+}
+
+// Time spent inside delay()/delayMicroseconds(), so measurements can leave
+// out deliberate pacing.
+inline uint64_t &sleptUs() {
+  static uint64_t total = 0;
+  return total;
+}
+
+inline uint64_t nowUs() {
+  if (scheduler()) return scheduler()->nowUs();
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start())
+    .count();
+}
+
+}  // namespace NativeClock
+
+inline unsigned long millis() { return (unsigned long)(NativeClock::nowUs() / 1000ULL); }
+inline unsigned long micros() { return (unsigned long)NativeClock::nowUs(); }
+
+namespace NativeClock {
+
+inline void sleep(uint64_t us) {
+  const uint64_t startUs = nowUs();
+  if (scheduler()) {
+    scheduler()->sleepUs(us);
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  }
+  sleptUs() += nowUs() - startUs;
+}
+
+}  // namespace NativeClock
+
+inline void delayMicroseconds(unsigned int us) { NativeClock::sleep(us); }
+inline void delay(unsigned long ms) { NativeClock::sleep((uint64_t)ms * 1000ULL); }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline void dacWrite(uint8_t, uint8_t) {}
+inline void dacDisable(uint8_t) {}
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t, uint32_t) {}
+
+inline uint32_t esp_random() {
+  static std::mt19937 rng(0x4f4c594d);
+  return (uint32_t)rng();
+}
+
+inline void configTime(long, int, const char *, const char * = nullptr, const char * = nullptr) {}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  const size_t len = strlen(src);
+  if (size) {
+    const size_t n = (len >= size) ? size - 1 : len;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+class String {
+public:
+  String() {}
+  String(const char *s) : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(int v) : _s(std::to_string(v)) {}
+  explicit String(unsigned int v) : _s(std::to_string(v)) {}
+  explicit String(long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long v) : _s(std::to_string(v)) {}
+
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  const char *c_str() const { return _s.c_str(); }
+  bool isEmpty() const { return _s.empty(); }
+  bool reserve(unsigned int size) {
+    _s.reserve(size);
+    return true;
+  }
+
+  char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : '\0'; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  bool concat(const String &s) {
+    _s += s._s;
+    return true;
+  }
+  bool concat(const char *s) {
+    _s += s;
+    return true;
+  }
+  bool concat(char c) {
+    _s += c;
+    return true;
+  }
+  String &operator+=(const String &s) {
+    _s += s._s;
+    return *this;
+  }
+  String &operator+=(const char *s) {
+    _s += s;
+    return *this;
+  }
+  String &operator+=(char c) {
+    _s += c;
+    return *this;
+  }
+
+  bool operator==(const String &o) const { return _s == o._s; }
+  bool operator==(const char *o) const { return _s == (o ? o : ""); }
+  bool operator!=(const String &o) const { return _s != o._s; }
+  bool operator!=(const char *o) const { return !(*this == o); }
+  bool operator<(const String &o) const { return _s < o._s; }
+  bool equals(const String &o) const { return _s == o._s; }
+  bool equalsIgnoreCase(const String &o) const { return strcasecmp(_s.c_str(), o._s.c_str()) == 0; }
+  bool startsWith(const String &p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+  bool endsWith(const String &p) const {
+    return _s.size() >= p._s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+  int indexOf(const String &s, unsigned int from = 0) const { return find(_s.find(s._s, from)); }
+  int lastIndexOf(char c) const { return find(_s.rfind(c)); }
+  String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < _s.size() ? String(_s.substr(from, to - from)) : String();
+  }
+
+  void replace(const String &find, const String &with) {
+    if (find._s.empty()) return;
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+      _s.replace(pos, find._s.size(), with._s);
+      pos += with._s.size();
+    }
+  }
+  void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+    if (index < _s.size()) _s.erase(index, count);
+  }
+  void trim() {
+    const size_t a = _s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) {
+      _s.clear();
+      return;
+    }
+    _s = _s.substr(a, _s.find_last_not_of(" \t\r\n") - a + 1);
+  }
+  void toUpperCase() {
+    for (char &c : _s) c = (char)toupper((unsigned char)c);
+  }
+  void toLowerCase() {
+    for (char &c : _s) c = (char)tolower((unsigned char)c);
+  }
+  long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+
+private:
+  std::string _s;
+
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+inline String operator+(const String &a, const String &b) {
+  String out(a);
+  out += b;
+  return out;
+}
+inline String operator+(const String &a, const char *b) {
+  String out(a);
+  out += b;
+  return out;
+}
+inline String operator+(const char *a, const String &b) {
+  String out(a);
+  out += b;
+  return out;
+}
+inline String operator+(const String &a, char b) {
+  String out(a);
+  out += b;
+  return out;
+}
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buf[n])) n++;
+    return n;
+  }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+    return write((const uint8_t *)buf, (size_t)len);
+  }
+  size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t println() { return print("\n"); }
+  size_t println(const char *s) { return print(s) + println(); }
+  size_t println(const String &s) { return println(s.c_str()); }
+  size_t println(long v) { return print(v) + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long timeoutMs) { _timeoutMs = timeoutMs; }
+  unsigned long getTimeout() const { return _timeoutMs; }
+
+  // Host sources never stall, so the timed reads reduce to plain loops.
+  virtual size_t readBytes(char *buf, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+      const int c = read();
+      if (c < 0) break;
+      buf[n++] = (char)c;
+    }
+    return n;
+  }
+  size_t readBytes(uint8_t *buf, size_t length) { return readBytes((char *)buf, length); }
+
+  size_t readBytesUntil(char terminator, char *buf, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+      const int c = read();
+      if (c < 0 || c == terminator) break;
+      buf[n++] = (char)c;
+    }
+    return n;
+  }
+
+protected:
+  unsigned long _timeoutMs = 1000;
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override {
+    if (nativeMuted()) return 1;
+    return fputc(c, stdout) == EOF ? 0 : 1;
+  }
+  size_t write(const uint8_t *buf, size_t size) override {
+    if (nativeMuted()) return size;
+    return fwrite(buf, 1, size, stdout);
+  }
+
+  // Lets a host harness silence firmware logging around its own report.
+  static bool &nativeMuted() {
+    static bool muted = false;
+    return muted;
+  }
+};
+
+inline HardwareSerial Serial;
+
+// Heap figures are meaningless on the host; report a roomy ESP32-like heap so
+// allocation gates behave as on a freshly booted board.
+struct EspClass {
+  uint32_t getFreeHeap() const { return 200 * 1024; }
+  uint32_t getMinFreeHeap() const { return 180 * 1024; }
+  uint32_t getMaxAllocHeap() const { return 110 * 1024; }
+  uint32_t getHeapSize() const { return 300 * 1024; }
+};
+
+inline EspClass ESP;
+
+// The ESP32 core pulls the FreeRTOS API in with Arduino.h.
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
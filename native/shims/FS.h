@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Arduino.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <memory>
+
+// Host filesystem shim: paths are rooted at a directory on disk
+// (NativeFs::root(), `OLYMPICS_FS_ROOT` or ./native_fs by default) and files
+// are plain stdio handles.
+namespace NativeFs {
+
+inline std::string &root() {
+  static std::string dir = getenv("OLYMPICS_FS_ROOT") ? getenv("OLYMPICS_FS_ROOT") : "native_fs";
+  return dir;
+}
+
+inline std::string hostPath(const char *path) {
+  std::string out = root();
+  if (!path || path[0] != '/') out += '/';
+  if (path) out += path;
+  return out;
+}
+
+// SPIFFS has no directories, so writes may name any "/a/b" path; create the
+// host directories on demand.
+inline void makeParents(const std::string &path) {
+  for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+    mkdir(path.substr(0, pos).c_str(), 0755);
+  }
+}
+
+}  // namespace NativeFs
+
+namespace fs {
+
+enum SeekMode {
+  SeekSet = SEEK_SET,
+  SeekCur = SEEK_CUR,
+  SeekEnd = SEEK_END
+};
+
+class File : public Stream {
+public:
+  File() {}
+  File(FILE *f, const char *path) : _f(f, fclose), _path(path) {}
+  File(DIR *d, const char *path) : _dir(d, closedir), _path(path) {}
+
+  int available() override {
+    if (!_f) return 0;
+    const long pos = ftell(_f.get());
+    return (int)(size() - (size_t)pos);
+  }
+  int read() override { return _f ? fgetc(_f.get()) : -1; }
+  int peek() override {
+    if (!_f) return -1;
+    const int c = fgetc(_f.get());
+    if (c != EOF) ungetc(c, _f.get());
+    return c;
+  }
+  size_t read(uint8_t *buf, size_t size) { return _f ? fread(buf, 1, size, _f.get()) : 0; }
+  size_t readBytes(char *buf, size_t length) override { return read((uint8_t *)buf, length); }
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return _f && fputc(c, _f.get()) != EOF ? 1 : 0; }
+  size_t write(const uint8_t *buf, size_t size) override { return _f ? fwrite(buf, 1, size, _f.get()) : 0; }
+  void flush() override {
+    if (_f) fflush(_f.get());
+  }
+
+  bool seek(uint32_t pos, SeekMode mode = SeekSet) { return _f && fseek(_f.get(), (long)pos, mode) == 0; }
+  size_t position() const { return _f ? (size_t)ftell(_f.get()) : 0; }
+  size_t size() const {
+    struct stat st;
+    return (_f && fstat(fileno(_f.get()), &st) == 0) ? (size_t)st.st_size : 0;
+  }
+  const char *path() const { return _path.c_str(); }
+  const char *name() const {
+    const size_t slash = _path.rfind('/');
+    return _path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+  }
+  bool isDirectory() const { return (bool)_dir; }
+  // Next regular file in a directory handle, opened for reading.
+  File openNextFile() {
+    if (!_dir) return File();
+    while (struct dirent *e = readdir(_dir.get())) {
+      const std::string path = _path + "/" + e->d_name;
+      struct stat st;
+      if (stat(NativeFs::hostPath(path.c_str()).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+      FILE *f = fopen(NativeFs::hostPath(path.c_str()).c_str(), "rb");
+      if (f) return File(f, path.c_str());
+    }
+    return File();
+  }
+  void close() {
+    _f.reset();
+    _dir.reset();
+  }
+  explicit operator bool() const { return _f || _dir; }
+
+private:
+  std::shared_ptr<FILE> _f;
+  std::shared_ptr<DIR> _dir;
+  std::string _path;
+};
+
+class FS {
+public:
+  File open(const char *path, const char *mode = "r", bool create = false) {
+    (void)create;
+    const std::string host = NativeFs::hostPath(path);
+    struct stat st;
+    if (mode[0] == 'r' && stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+      DIR *d = opendir(host.c_str());
+      return d ? File(d, path) : File();
+    }
+    if (mode[0] != 'r') NativeFs::makeParents(host);
+    const std::string stdioMode = std::string(mode) + "b";
+    FILE *f = fopen(host.c_str(), stdioMode.c_str());
+    return f ? File(f, path) : File();
+  }
+  File open(const String &path, const char *mode = "r", bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+
+  bool exists(const char *path) {
+    struct stat st;
+    return stat(NativeFs::hostPath(path).c_str(), &st) == 0;
+  }
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path) { return ::remove(NativeFs::hostPath(path).c_str()) == 0; }
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to) {
+    return ::rename(NativeFs::hostPath(from).c_str(), NativeFs::hostPath(to).c_str()) == 0;
+  }
+  bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char *path) {
+    const std::string host = NativeFs::hostPath(path);
+    NativeFs::makeParents(host + "/");
+    return true;
+  }
+  bool mkdir(const String &path) { return mkdir(path.c_str()); }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekSet;
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <zlib.h>
+
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+enum followRedirects_t {
+  HTTPC_DISABLE_FOLLOW_REDIRECTS,
+  HTTPC_STRICT_FOLLOW_REDIRECTS,
+  HTTPC_FORCE_FOLLOW_REDIRECTS
+};
+
+// Fixture-backed HTTP: each URL is answered from a file in NativeHttp::dir()
+// (`OLYMPICS_FIXTURES`, default ./fixtures) named after the URL with the
+// scheme dropped and anything outside [A-Za-z0-9.-] turned into '_', plus
+// ".json". Missing fixtures answer 404. The ETag is a hash of the body, so
+// conditional requests get 304s; OLYMPICS_HTTP_CHUNKED=1 serves bodies with
+// chunked framing, and OLYMPICS_HTTP_GZIP=1 gzips them for clients that send
+// Accept-Encoding: gzip. A harness can replace the fixture lookup with its own
+// responder, observe every request and model link latency.
+namespace NativeHttp {
+
+inline std::string &dir() {
+  static std::string path = getenv("OLYMPICS_FIXTURES") ? getenv("OLYMPICS_FIXTURES") : "fixtures";
+  return path;
+}
+
+inline bool &chunked() {
+  static bool on = getenv("OLYMPICS_HTTP_CHUNKED") && atoi(getenv("OLYMPICS_HTTP_CHUNKED")) != 0;
+  return on;
+}
+
+inline bool &gzip() {
+  static bool on = getenv("OLYMPICS_HTTP_GZIP") && atoi(getenv("OLYMPICS_HTTP_GZIP")) != 0;
+  return on;
+}
+
+inline std::string fixtureName(const std::string &url) {
+  const size_t scheme = url.find("://");
+  std::string name = url.substr(scheme == std::string::npos ? 0 : scheme + 3);
+  for (char &c : name) {
+    if (!isalnum((unsigned char)c) && c != '.' && c != '-') c = '_';
+  }
+  return name + ".json";
+}
+
+inline bool readFile(const std::string &path, std::string &body) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  body.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) body.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+inline std::string etagFor(const std::string &body) {
+  uint32_t h = 2166136261u;
+  for (char c : body) {
+    h ^= (uint8_t)c;
+    h *= 16777619u;
+  }
+  char tag[16];
+  snprintf(tag, sizeof(tag), "\"%08x\"", (unsigned)h);
+  return tag;
+}
+
+// Splits the body into pseudo-random chunk sizes so decoders see chunk
+// boundaries inside tokens.
+inline std::string chunk(const std::string &body) {
+  std::string out;
+  size_t pos = 0;
+  uint32_t seed = 0x9E3779B9u;
+  while (pos < body.size()) {
+    seed = seed * 1664525u + 1013904223u;
+    const size_t len = std::min(body.size() - pos, (size_t)(1 + (seed >> 24) % 700));
+    char header[16];
+    snprintf(header, sizeof(header), "%zx\r\n", len);
+    out += header;
+    out.append(body, pos, len);
+    out += "\r\n";
+    pos += len;
+  }
+  out += "0\r\n\r\n";
+  return out;
+}
+
+// gzip at zlib's default level, as CDNs typically serve it.
+inline std::string gzipped(const std::string &body) {
+  z_stream zs = {};
+  std::string out;
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return out;
+  out.resize(deflateBound(&zs, (uLong)body.size()) + 32);
+  zs.next_in = (Bytef *)body.data();
+  zs.avail_in = (uInt)body.size();
+  zs.next_out = (Bytef *)&out[0];
+  zs.avail_out = (uInt)out.size();
+  deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+struct Response {
+  std::shared_ptr<const std::string> plain;
+  std::shared_ptr<const std::string> chunked;
+  std::shared_ptr<const std::string> gzip;
+  std::shared_ptr<const std::string> gzipChunked;
+  std::string etag;
+};
+
+inline std::shared_ptr<const Response> makeResponse(std::string body) {
+  auto r = std::make_shared<Response>();
+  r->etag = etagFor(body);
+  const std::string compressed = gzipped(body);
+  r->gzip = std::make_shared<const std::string>(compressed);
+  r->gzipChunked = std::make_shared<const std::string>(chunk(compressed));
+  r->chunked = std::make_shared<const std::string>(chunk(body));
+  r->plain = std::make_shared<const std::string>(std::move(body));
+  return r;
+}
+
+// Returns nullptr for 404.
+typedef std::function<std::shared_ptr<const Response>(const std::string &url)> Responder;
+
+inline Responder &responder() {
+  static Responder fn;
+  return fn;
+}
+
+// Called once per request with the status and the bytes put on the wire.
+typedef std::function<void(const std::string &url, int code, size_t bytes)> Observer;
+
+inline Observer &observer() {
+  static Observer fn;
+  return fn;
+}
+
+// Modelled request time, spent in delay(): a fixed round trip plus transfer.
+struct Link {
+  uint32_t roundTripMs = 0;
+  uint32_t bytesPerSec = 0;
+};
+
+inline Link &link() {
+  static Link l;
+  return l;
+}
+
+// Files are read and framed once per path, then shared, so repeated requests
+// cost no file I/O or allocation inside the shim. Returns nullptr if the file
+// is missing.
+inline std::shared_ptr<const Response> fileResponse(const std::string &path) {
+  static std::mutex lock;
+  static std::map<std::string, std::shared_ptr<const Response>> cache;
+  std::lock_guard<std::mutex> guard(lock);
+  auto it = cache.find(path);
+  if (it == cache.end()) {
+    std::string body;
+    if (!readFile(path, body)) return nullptr;
+    it = cache.emplace(path, makeResponse(std::move(body))).first;
+  }
+  return it->second;
+}
+
+// A responder may fall back to this for URLs it doesn't answer itself.
+inline std::shared_ptr<const Response> fixtureResponse(const std::string &url) {
+  return fileResponse(dir() + "/" + fixtureName(url));
+}
+
+// Answers a URL naming "<code>.png" from <pngDir>/<CODE>.png, wherever the
+// name sits: in the path, or in a resizing proxy's img= parameter. Returns
+// nullptr for anything else, so a responder can fall through.
+inline std::shared_ptr<const Response> pngResponse(const std::string &url, const std::string &pngDir) {
+  const size_t ext = url.find(".png");
+  if (ext == std::string::npos) return nullptr;
+  const size_t slash = url.rfind('/', ext);
+  if (slash == std::string::npos) return nullptr;
+  std::string code = url.substr(slash + 1, ext - slash - 1);
+  for (char &c : code) c = (char)toupper((unsigned char)c);
+  return fileResponse(pngDir + "/" + code + ".png");
+}
+
+inline std::shared_ptr<const Response> response(const std::string &url) {
+  return responder() ? responder()(url) : fixtureResponse(url);
+}
+
+inline void finish(const std::string &url, int code, size_t bytes) {
+  const Link &l = link();
+  uint64_t us = (uint64_t)l.roundTripMs * 1000ULL;
+  if (l.bytesPerSec) us += (uint64_t)bytes * 1000000ULL / l.bytesPerSec;
+  if (us) NativeClock::sleep(us);
+  if (observer()) observer()(url, code, bytes);
+}
+
+}  // namespace NativeHttp
+
+class HTTPClient {
+public:
+  bool begin(WiFiClient &client, const String &url) {
+    _client = &client;
+    _url = url;
+    _ifNoneMatch = String();
+    _etag = String();
+    _acceptGzip = false;
+    _chunked = false;
+    _gzip = false;
+    _size = -1;
+    return true;
+  }
+  void end() { _client = nullptr; }
+
+  void setTimeout(uint16_t) {}
+  void setConnectTimeout(int32_t) {}
+  void setFollowRedirects(followRedirects_t) {}
+  void setReuse(bool) {}
+  void useHTTP10(bool) {}
+  void collectHeaders(const char *[], size_t) {}
+  void addHeader(const String &name, const String &value) {
+    if (name.equalsIgnoreCase("If-None-Match")) _ifNoneMatch = value;
+  }
+  void setAcceptEncoding(const String &value) { _acceptGzip = strstr(value.c_str(), "gzip") != nullptr; }
+
+  int GET() {
+    if (!_client) return HTTPC_ERROR_CONNECTION_REFUSED;
+    const std::string url = _url.c_str();
+    const std::shared_ptr<const NativeHttp::Response> r = NativeHttp::response(url);
+    if (!r) {
+      _client->nativeLoadResponse(nullptr);
+      NativeHttp::finish(url, 404, 0);
+      return 404;
+    }
+
+    _etag = r->etag.c_str();
+    if (_ifNoneMatch == _etag) {
+      _client->nativeLoadResponse(nullptr);
+      _size = 0;
+      NativeHttp::finish(url, 304, 0);
+      return 304;
+    }
+
+    _chunked = NativeHttp::chunked();
+    _gzip = _acceptGzip && NativeHttp::gzip();
+    const std::shared_ptr<const std::string> &body =
+      _gzip ? (_chunked ? r->gzipChunked : r->gzip) : (_chunked ? r->chunked : r->plain);
+    _client->nativeLoadResponse(body);
+    _size = _chunked ? -1 : (int)body->size();
+    NativeHttp::finish(url, 200, body->size());
+    return 200;
+  }
+
+  int getSize() const { return _size; }
+  WiFiClient &getStream() { return *_client; }
+  WiFiClient *getStreamPtr() { return _client; }
+  bool connected() { return _client && _client->connected(); }
+
+  bool hasHeader(const char *name) const { return header(name).length() != 0; }
+  String header(const char *name) const {
+    if (!strcasecmp(name, "ETag")) return _etag;
+    if (!strcasecmp(name, "Transfer-Encoding") && _chunked) return String("chunked");
+    if (!strcasecmp(name, "Content-Encoding") && _gzip) return String("gzip");
+    return String();
+  }
+
+private:
+  WiFiClient *_client = nullptr;
+  String _url;
+  String _ifNoneMatch;
+  String _etag;
+  bool _acceptGzip = false;
+  bool _chunked = false;
+  bool _gzip = false;
+  int _size = -1;
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <vector>
+
+#include <zlib.h>
+
+// PNGdec's callback API over zlib: the file is read whole through the read
+// callback, inflated and unfiltered, and every row handed to the draw
+// callback. Non-interlaced 8-bit greyscale, truecolour and indexed images,
+// with or without alpha, are decoded; anything else reports
+// PNG_UNSUPPORTED_FEATURE.
+
+#define PNG_RGB565_LITTLE_ENDIAN 0
+#define PNG_RGB565_BIG_ENDIAN 1
+
+enum {
+  PNG_SUCCESS = 0,
+  PNG_INVALID_PARAMETER,
+  PNG_DECODE_ERROR,
+  PNG_MEM_ERROR,
+  PNG_NO_BUFFER,
+  PNG_UNSUPPORTED_FEATURE,
+  PNG_INVALID_FILE,
+  PNG_TOO_BIG,
+  PNG_QUIT_EARLY
+};
+
+enum {
+  PNG_PIXEL_GRAYSCALE = 0,
+  PNG_PIXEL_TRUECOLOR = 2,
+  PNG_PIXEL_INDEXED = 3,
+  PNG_PIXEL_GRAY_ALPHA = 4,
+  PNG_PIXEL_TRUECOLOR_ALPHA = 6
+};
+
+struct PNGFILE {
+  int32_t iPos;
+  int32_t iSize;
+  uint8_t *pData;
+  void *fHandle;
+};
+
+struct PNGDRAW {
+  int y;
+  int iWidth;
+  int iPixelType;
+  int iBpp;
+  int iHasAlpha;
+  void *pUser;
+  uint8_t *pPixels;
+  uint8_t *pPalette;
+};
+
+typedef void *(PNG_OPEN_CALLBACK)(const char *szFilename, int32_t *pFileSize);
+typedef void(PNG_CLOSE_CALLBACK)(void *pHandle);
+typedef int32_t(PNG_READ_CALLBACK)(PNGFILE *pFile, uint8_t *pBuf, int32_t iLen);
+typedef int32_t(PNG_SEEK_CALLBACK)(PNGFILE *pFile, int32_t iPosition);
+typedef int(PNG_DRAW_CALLBACK)(PNGDRAW *pDraw);
+
+class PNG {
+public:
+  int open(const char *szFilename,
+           PNG_OPEN_CALLBACK *pfnOpen,
+           PNG_CLOSE_CALLBACK *pfnClose,
+           PNG_READ_CALLBACK *pfnRead,
+           PNG_SEEK_CALLBACK *pfnSeek,
+           PNG_DRAW_CALLBACK *pfnDraw) {
+    *this = PNG();
+    _close = pfnClose;
+    _draw = pfnDraw;
+    _file.fHandle = pfnOpen(szFilename, &_file.iSize);
+    if (!_file.fHandle) return _error = PNG_INVALID_FILE;
+    pfnSeek(&_file, 0);
+    _bytes.resize(_file.iSize > 0 ? (size_t)_file.iSize : 0);
+    size_t got = 0;
+    while (got < _bytes.size()) {
+      const int32_t n = pfnRead(&_file, &_bytes[got], (int32_t)(_bytes.size() - got));
+      if (n <= 0) break;
+      got += (size_t)n;
+    }
+    _bytes.resize(got);
+    return _error = readHeader();
+  }
+
+  void close() {
+    if (_close && _file.fHandle) _close(_file.fHandle);
+    _file.fHandle = nullptr;
+  }
+
+  int getWidth() const { return _width; }
+  int getHeight() const { return _height; }
+  int getBpp() const { return _bitDepth; }
+  int hasAlpha() const { return _pixelType == PNG_PIXEL_GRAY_ALPHA || _pixelType == PNG_PIXEL_TRUECOLOR_ALPHA || _hasTrns; }
+  int getPixelType() const { return _pixelType; }
+  int isInterlaced() const { return _interlaced; }
+  int getLastError() const { return _error; }
+
+  int decode(void *pUser, int iOptions) {
+    (void)iOptions;
+    if (_error != PNG_SUCCESS) return _error;
+    std::vector<uint8_t> raw;
+    if (!inflateData(raw)) return _error = PNG_DECODE_ERROR;
+
+    const size_t stride = (size_t)_width * _channels;
+    if (raw.size() < (stride + 1) * (size_t)_height) return _error = PNG_DECODE_ERROR;
+    std::vector<uint8_t> prev(stride, 0);
+    std::vector<uint8_t> line(stride);
+    for (int y = 0; y < _height; ++y) {
+      const uint8_t *in = &raw[y * (stride + 1)];
+      if (!unfilter(in[0], in + 1, prev.data(), line.data(), stride)) return _error = PNG_DECODE_ERROR;
+      PNGDRAW draw = {};
+      draw.y = y;
+      draw.iWidth = _width;
+      draw.iPixelType = _pixelType;
+      draw.iBpp = _bitDepth;
+      draw.iHasAlpha = hasAlpha();
+      draw.pUser = pUser;
+      draw.pPixels = line.data();
+      draw.pPalette = _palette;
+      if (_draw && !_draw(&draw)) return _error = PNG_QUIT_EARLY;
+      prev.swap(line);
+      line.assign(stride, 0);
+    }
+    return PNG_SUCCESS;
+  }
+
+  // Blends any alpha over u32Bkgd (0xRRGGBB).
+  void getLineAsRGB565(PNGDRAW *pDraw, uint16_t *pPixels, int iEndianness, uint32_t u32Bkgd) const {
+    const uint8_t bgR = (uint8_t)(u32Bkgd >> 16);
+    const uint8_t bgG = (uint8_t)(u32Bkgd >> 8);
+    const uint8_t bgB = (uint8_t)u32Bkgd;
+    for (int x = 0; x < pDraw->iWidth; ++x) {
+      uint8_t r, g, b, a = 255;
+      const uint8_t *p = pDraw->pPixels + x * _channels;
+      switch (pDraw->iPixelType) {
+        case PNG_PIXEL_GRAYSCALE: r = g = b = p[0]; break;
+        case PNG_PIXEL_GRAY_ALPHA: r = g = b = p[0]; a = p[1]; break;
+        case PNG_PIXEL_TRUECOLOR: r = p[0]; g = p[1]; b = p[2]; break;
+        case PNG_PIXEL_INDEXED:
+          r = pDraw->pPalette[p[0] * 3];
+          g = pDraw->pPalette[p[0] * 3 + 1];
+          b = pDraw->pPalette[p[0] * 3 + 2];
+          a = pDraw->pPalette[768 + p[0]];
+          break;
+        default: r = p[0]; g = p[1]; b = p[2]; a = p[3]; break;
+      }
+      r = blend(r, bgR, a);
+      g = blend(g, bgG, a);
+      b = blend(b, bgB, a);
+      uint16_t c = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+      if (iEndianness == PNG_RGB565_BIG_ENDIAN) c = (uint16_t)((c >> 8) | (c << 8));
+      pPixels[x] = c;
+    }
+  }
+
+private:
+  PNGFILE _file = {};
+  PNG_CLOSE_CALLBACK *_close = nullptr;
+  PNG_DRAW_CALLBACK *_draw = nullptr;
+  std::vector<uint8_t> _bytes;
+  int _error = PNG_SUCCESS;
+  int _width = 0;
+  int _height = 0;
+  int _bitDepth = 0;
+  int _pixelType = 0;
+  int _channels = 0;
+  int _interlaced = 0;
+  bool _hasTrns = false;
+  // RGB triplets, then one alpha per entry.
+  uint8_t _palette[768 + 256] = {};
+
+  static uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+  }
+  static uint8_t blend(uint8_t fg, uint8_t bg, uint8_t a) { return (uint8_t)((fg * a + bg * (255 - a)) / 255); }
+
+  int readHeader() {
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (_bytes.size() < 33 || memcmp(_bytes.data(), kSignature, 8) != 0 || memcmp(&_bytes[12], "IHDR", 4) != 0) {
+      return PNG_INVALID_FILE;
+    }
+    _width = (int)be32(&_bytes[16]);
+    _height = (int)be32(&_bytes[20]);
+    _bitDepth = _bytes[24];
+    _pixelType = _bytes[25];
+    _interlaced = _bytes[28];
+    switch (_pixelType) {
+      case PNG_PIXEL_GRAYSCALE: _channels = 1; break;
+      case PNG_PIXEL_INDEXED: _channels = 1; break;
+      case PNG_PIXEL_GRAY_ALPHA: _channels = 2; break;
+      case PNG_PIXEL_TRUECOLOR: _channels = 3; break;
+      case PNG_PIXEL_TRUECOLOR_ALPHA: _channels = 4; break;
+      default: return PNG_INVALID_FILE;
+    }
+    if (_width <= 0 || _height <= 0) return PNG_INVALID_FILE;
+    if (_bitDepth != 8 || _interlaced) return PNG_UNSUPPORTED_FEATURE;
+    memset(&_palette[768], 255, 256);
+    return PNG_SUCCESS;
+  }
+
+  // Concatenates the IDAT chunks and inflates them; PLTE and tRNS fill the
+  // palette on the way.
+  bool inflateData(std::vector<uint8_t> &out) {
+    std::vector<uint8_t> zdata;
+    size_t pos = 8;
+    while (pos + 12 <= _bytes.size()) {
+      const uint32_t len = be32(&_bytes[pos]);
+      const uint8_t *type = &_bytes[pos + 4];
+      const uint8_t *data = &_bytes[pos + 8];
+      if (pos + 12 + (size_t)len > _bytes.size()) return false;
+      if (!memcmp(type, "IDAT", 4)) {
+        zdata.insert(zdata.end(), data, data + len);
+      } else if (!memcmp(type, "PLTE", 4)) {
+        memcpy(_palette, data, std::min<size_t>(len, 768));
+      } else if (!memcmp(type, "tRNS", 4) && _pixelType == PNG_PIXEL_INDEXED) {
+        memcpy(&_palette[768], data, std::min<size_t>(len, 256));
+        _hasTrns = true;
+      } else if (!memcmp(type, "IEND", 4)) {
+        break;
+      }
+      pos += 12 + len;
+    }
+
+    out.resize(((size_t)_width * _channels + 1) * _height);
+    uLongf outLen = (uLongf)out.size();
+    if (uncompress(out.data(), &outLen, zdata.data(), (uLong)zdata.size()) != Z_OK) return false;
+    out.resize(outLen);
+    return true;
+  }
+
+  bool unfilter(uint8_t filter, const uint8_t *in, const uint8_t *prev, uint8_t *out, size_t stride) const {
+    const size_t bpp = (size_t)_channels;
+    for (size_t i = 0; i < stride; ++i) {
+      const int a = i >= bpp ? out[i - bpp] : 0;
+      const int b = prev[i];
+      const int c = i >= bpp ? prev[i - bpp] : 0;
+      int pred;
+      switch (filter) {
+        case 0: pred = 0; break;
+        case 1: pred = a; break;
+        case 2: pred = b; break;
+        case 3: pred = (a + b) / 2; break;
+        case 4: {
+          const int p = a + b - c;
+          const int pa = abs(p - a);
+          const int pb = abs(p - b);
+          const int pc = abs(p - c);
+          pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+          break;
+        }
+        default: return false;
+      }
+      out[i] = (uint8_t)(in[i] + pred);
+    }
+    return true;
+  }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+#include <vector>
+
+// In-memory NVS: survives for the life of the process, which is enough to
+// exercise save/load round trips within one run.
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false) {
+    _ns = name;
+    _readOnly = readOnly;
+    return true;
+  }
+  void end() { _ns.clear(); }
+
+  bool isKey(const char *key) { return store().count(fullKey(key)) != 0; }
+  bool remove(const char *key) { return !_readOnly && store().erase(fullKey(key)) != 0; }
+  bool clear() {
+    if (_readOnly) return false;
+    const std::string prefix = _ns + "/";
+    for (auto it = store().begin(); it != store().end();) {
+      it = (it->first.compare(0, prefix.size(), prefix) == 0) ? store().erase(it) : std::next(it);
+    }
+    return true;
+  }
+
+  size_t getBytesLength(const char *key) {
+    auto it = store().find(fullKey(key));
+    return it == store().end() ? 0 : it->second.size();
+  }
+  size_t getBytes(const char *key, void *buf, size_t maxLen) {
+    auto it = store().find(fullKey(key));
+    if (it == store().end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+  size_t putBytes(const char *key, const void *value, size_t len) {
+    if (_readOnly) return 0;
+    const uint8_t *bytes = (const uint8_t *)value;
+    store()[fullKey(key)].assign(bytes, bytes + len);
+    return len;
+  }
+
+private:
+  std::string _ns;
+  bool _readOnly = false;
+
+  std::string fullKey(const char *key) const { return _ns + "/" + key; }
+  static std::map<std::string, std::vector<uint8_t>> &store() {
+    static std::map<std::string, std::vector<uint8_t>> blobs;
+    return blobs;
+  }
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "FS.h"
+#include "SPI.h"
+
+// There is never a card on the host: begin() fails and callers fall back to
+// SPIFFS, as on a board without one.
+class SDFS : public fs::FS {
+public:
+  bool begin(uint8_t = 5, SPIClass & = SPI, uint32_t = 4000000, const char * = "/sd", uint8_t = 5) { return false; }
+  void end() {}
+};
+
+inline SDFS SD;
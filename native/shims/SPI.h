@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define HSPI 2
+#define VSPI 3
+
+// Bus objects only; nothing on the host talks SPI.
+class SPIClass {
+public:
+  explicit SPIClass(uint8_t bus = HSPI) : _bus(bus) {}
+  void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+  void end() {}
+
+private:
+  uint8_t _bus;
+};
+
+inline SPIClass SPI(VSPI);
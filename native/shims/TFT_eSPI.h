@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <vector>
+
+#ifndef TFT_BL
+#define TFT_BL 21
+#endif
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+
+// Panel backed by an RGB565 framebuffer in RAM, so a host harness can read
+// back what the firmware drew and count the pixels each call touched. Shapes
+// are filled exactly except for rounded corners, which stay square; text is
+// counted but not rasterised.
+class TFT_eSPI {
+public:
+  TFT_eSPI() : _pixels(240 * 320, 0) {}
+
+  void init() {}
+  void setRotation(uint8_t rotation) { _rotation = rotation & 3; }
+  uint8_t getRotation() const { return _rotation; }
+  int16_t width() const { return (_rotation & 1) ? 320 : 240; }
+  int16_t height() const { return (_rotation & 1) ? 240 : 320; }
+
+  void setSwapBytes(bool swap) { _swapBytes = swap; }
+  bool getSwapBytes() const { return _swapBytes; }
+
+  void fillScreen(uint32_t color) { fillRect(0, 0, width(), height(), color); }
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    for (int32_t row = y; row < y + h; ++row) {
+      for (int32_t col = x; col < x + w; ++col) plot(col, row, (uint16_t)color);
+    }
+  }
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color) { fillRect(x, y, w, h, color); }
+  void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color) { drawRect(x, y, w, h, color); }
+
+  // Stored as given unless swap-bytes is on, like the SPI write it stands for.
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data) {
+    for (int32_t row = 0; row < h; ++row) {
+      for (int32_t col = 0; col < w; ++col) {
+        uint16_t c = data[row * w + col];
+        if (_swapBytes) c = (uint16_t)((c >> 8) | (c << 8));
+        plot(x + col, y + row, c);
+      }
+    }
+  }
+
+  void setTextDatum(uint8_t datum) { _datum = datum; }
+  void setTextColor(uint16_t fg) { _textFg = fg; }
+  void setTextColor(uint16_t fg, uint16_t bg) {
+    _textFg = fg;
+    _textBg = bg;
+  }
+  void setTextFont(uint8_t font) { _font = font; }
+  void setTextSize(uint8_t) {}
+  int16_t textWidth(const char *s) const { return (int16_t)(strlen(s) * (_font == 1 ? 6 : 8)); }
+  int16_t textWidth(const String &s) const { return textWidth(s.c_str()); }
+  int16_t fontHeight() const { return _font == 1 ? 8 : 16; }
+  int16_t drawString(const char *s, int32_t, int32_t) {
+    _textDraws++;
+    return textWidth(s);
+  }
+  int16_t drawString(const String &s, int32_t x, int32_t y) { return drawString(s.c_str(), x, y); }
+
+  uint16_t readPixel(int32_t x, int32_t y) const {
+    return inside(x, y) ? _pixels[(size_t)y * width() + x] : 0;
+  }
+
+  // Pixels written and strings drawn since the last reset.
+  uint32_t nativePixelsWritten() const { return _pixelsWritten; }
+  uint32_t nativeTextDraws() const { return _textDraws; }
+  void nativeResetCounters() {
+    _pixelsWritten = 0;
+    _textDraws = 0;
+  }
+
+private:
+  std::vector<uint16_t> _pixels;
+  uint8_t _rotation = 0;
+  bool _swapBytes = false;
+  uint8_t _datum = TL_DATUM;
+  uint8_t _font = 1;
+  uint16_t _textFg = TFT_WHITE;
+  uint16_t _textBg = TFT_BLACK;
+  uint32_t _pixelsWritten = 0;
+  uint32_t _textDraws = 0;
+
+  bool inside(int32_t x, int32_t y) const { return x >= 0 && y >= 0 && x < width() && y < height(); }
+  void plot(int32_t x, int32_t y, uint16_t c) {
+    if (!inside(x, y)) return;
+    _pixels[(size_t)y * width() + x] = c;
+    _pixelsWritten++;
+  }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+// Link state is whatever the host harness says it is.
+class WiFiClass {
+public:
+  wl_status_t status() const { return nativeConnected() ? WL_CONNECTED : WL_DISCONNECTED; }
+
+  static bool &nativeConnected() {
+    static bool connected = true;
+    return connected;
+  }
+};
+
+inline WiFiClass WiFi;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <memory>
+
+// Socket stand-in: HTTPClient loads each response into the client's receive
+// buffer, and the body is then read back through the Stream interface.
+class WiFiClient : public Stream {
+public:
+  virtual ~WiFiClient() {}
+
+  int available() override { return (int)(size() - _pos); }
+  int read() override {
+    nativeReadCalls()++;
+    if (_pos >= size()) return -1;
+    nativeBytesRead()++;
+    return (uint8_t)(*_rx)[_pos++];
+  }
+  int peek() override { return _pos < size() ? (uint8_t)(*_rx)[_pos] : -1; }
+  int read(uint8_t *buf, size_t size) {
+    nativeReadCalls()++;
+    const size_t n = std::min(size, this->size() - _pos);
+    if (n) memcpy(buf, _rx->data() + _pos, n);
+    _pos += n;
+    nativeBytesRead() += n;
+    return (int)n;
+  }
+  size_t readBytes(char *buf, size_t length) override { return (size_t)read((uint8_t *)buf, length); }
+  using Stream::readBytes;
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t *, size_t size) override { return size; }
+
+  virtual uint8_t connected() { return _connected ? 1 : 0; }
+  virtual void stop() {
+    _connected = false;
+    _rx.reset();
+    _pos = 0;
+  }
+  explicit operator bool() { return _connected; }
+
+  // Response bytes pulled off every fake socket so far, framing included.
+  static size_t &nativeBytesRead() {
+    static size_t total = 0;
+    return total;
+  }
+
+  // Calls into the fake socket; on the device each one is an lwIP round trip
+  // through the socket lock, so this is the number to keep down.
+  static size_t &nativeReadCalls() {
+    static size_t total = 0;
+    return total;
+  }
+
+  // Shares the buffer rather than copying it, so the fake socket adds no
+  // allocations to whatever is being measured.
+  void nativeLoadResponse(std::shared_ptr<const std::string> bytes) {
+    _rx = std::move(bytes);
+    _pos = 0;
+    _connected = true;
+  }
+
+private:
+  size_t size() const { return _rx ? _rx->size() : 0; }
+
+  std::shared_ptr<const std::string> _rx;
+  size_t _pos = 0;
+  bool _connected = false;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setInsecure() {}
+  void setCACert(const char *) {}
+  void setTimeout(uint32_t seconds) { Stream::setTimeout(seconds); }
+  void setHandshakeTimeout(unsigned long) {}
+};
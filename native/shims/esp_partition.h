@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+
+#include "esp_spi_flash.h"
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL (-1)
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_SIZE 0x104
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_ANY = 0xff
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+  bool encrypted;
+} esp_partition_t;
+
+// Data partitions are image files: <label>.bin in NativePartition::dir()
+// (`OLYMPICS_PARTITIONS`, default ./native_partitions). A missing file is a
+// missing partition. Each image is read once and kept, so mappings stay valid.
+namespace NativePartition {
+
+inline std::string &dir() {
+  static std::string path = getenv("OLYMPICS_PARTITIONS") ? getenv("OLYMPICS_PARTITIONS") : "native_partitions";
+  return path;
+}
+
+struct Image {
+  esp_partition_t info;
+  std::string bytes;
+};
+
+inline const Image *load(const char *label) {
+  static std::map<std::string, Image> images;
+  const std::string path = dir() + "/" + label + ".bin";
+  auto it = images.find(path);
+  if (it != images.end()) return &it->second;
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return nullptr;
+  Image image = {};
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) image.bytes.append(buf, n);
+  fclose(f);
+  image.info.type = ESP_PARTITION_TYPE_DATA;
+  image.info.subtype = ESP_PARTITION_SUBTYPE_ANY;
+  image.info.size = (uint32_t)image.bytes.size();
+  strlcpy(image.info.label, label, sizeof(image.info.label));
+  return &images.emplace(path, std::move(image)).first->second;
+}
+
+inline const Image *of(const esp_partition_t *part) {
+  return part ? load(part->label) : nullptr;
+}
+
+}  // namespace NativePartition
+
+inline const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, int, const char *label) {
+  if (type != ESP_PARTITION_TYPE_DATA || !label) return nullptr;
+  const NativePartition::Image *image = NativePartition::load(label);
+  return image ? &image->info : nullptr;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size) {
+  const NativePartition::Image *image = NativePartition::of(part);
+  if (!image || !dst) return ESP_ERR_INVALID_ARG;
+  if (offset + size > image->bytes.size()) return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, image->bytes.data() + offset, size);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_partition_mmap(const esp_partition_t *part,
+                                    size_t offset,
+                                    size_t size,
+                                    spi_flash_mmap_memory_t,
+                                    const void **outPtr,
+                                    spi_flash_mmap_handle_t *outHandle) {
+  const NativePartition::Image *image = NativePartition::of(part);
+  if (!image || !outPtr) return ESP_ERR_INVALID_ARG;
+  if (offset + size > image->bytes.size()) return ESP_ERR_INVALID_SIZE;
+  *outPtr = image->bytes.data() + offset;
+  if (outHandle) *outHandle = 1;
+  return ESP_OK;
+}
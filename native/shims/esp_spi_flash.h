@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef enum {
+  SPI_FLASH_MMAP_DATA,
+  SPI_FLASH_MMAP_INST
+} spi_flash_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+// Mappings are host buffers that live as long as the process.
+inline void spi_flash_munmap(spi_flash_mmap_handle_t) {}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "FreeRTOS.h"
+
+// Copy-in/copy-out queue of fixed-size items. Calls never block; a timeout
+// is treated as zero.
+struct NativeQueue {
+  std::mutex lock;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+typedef NativeQueue *QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  NativeQueue *q = new NativeQueue();
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  if (q->items.size() >= q->length) return pdFALSE;
+  const uint8_t *bytes = (const uint8_t *)item;
+  q->items.emplace_back(bytes, bytes + q->itemSize);
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void *out, TickType_t) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  if (q->items.empty()) return pdFALSE;
+  memcpy(out, q->items.front().data(), q->itemSize);
+  q->items.pop_front();
+  return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  return (UBaseType_t)q->items.size();
+}
+
+inline UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  return q->length - (UBaseType_t)q->items.size();
+}
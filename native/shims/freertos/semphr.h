@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <mutex>
+
+#include "FreeRTOS.h"
+
+// Mutex semaphores only. Under a simulator's coroutines every task shares one
+// thread, so a mutex must never be held across a sleep; the firmware holds
+// its locks for a lookup or an update only.
+struct NativeSemaphore {
+  std::timed_mutex lock;
+};
+
+typedef NativeSemaphore *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new NativeSemaphore(); }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (ticks == portMAX_DELAY) {
+    sem->lock.lock();
+    return pdTRUE;
+  }
+  return sem->lock.try_lock_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  sem->lock.unlock();
+  return pdTRUE;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <condition_variable>
+#include <mutex>
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+// Per-task state behind a TaskHandle_t: the direct-to-task notification
+// count, plus what the task was started with.
+struct NativeTask {
+  TaskFunction_t fn = nullptr;
+  void *arg = nullptr;
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t count = 0;
+};
+
+// The task the caller runs in, or nullptr for the thread that ran main().
+inline NativeTask *&nativeCurrentTask() {
+  if (NativeClock::scheduler()) return (NativeTask *&)NativeClock::scheduler()->taskLocal();
+  static thread_local NativeTask *current = nullptr;
+  return current;
+}
+
+inline void nativeTaskEntry(void *arg) {
+  NativeTask *task = static_cast<NativeTask *>(arg);
+  nativeCurrentTask() = task;
+  task->fn(task->arg);
+}
+
+// Tasks become threads, or coroutines when a simulator owns the clock
+// (NativeClock::Scheduler). Core pinning and priorities are ignored.
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn,
+                                          const char *,
+                                          uint32_t,
+                                          void *arg,
+                                          UBaseType_t,
+                                          TaskHandle_t *handle,
+                                          BaseType_t) {
+  NativeTask *task = new NativeTask();
+  task->fn = fn;
+  task->arg = arg;
+  if (handle) *handle = task;
+  if (NativeClock::scheduler()) {
+    NativeClock::scheduler()->spawn(nativeTaskEntry, task);
+  } else {
+    std::thread(nativeTaskEntry, task).detach();
+  }
+  return pdPASS;
+}
+
+inline void vTaskDelay(TickType_t ticks) { delay(ticks * portTICK_PERIOD_MS); }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nativeCurrentTask(); }
+
+inline void xTaskNotifyGive(TaskHandle_t task) {
+  if (!task) return;
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->count++;
+  }
+  if (NativeClock::scheduler()) {
+    NativeClock::scheduler()->wake(task);
+  } else {
+    task->notified.notify_one();
+  }
+}
+
+// Waits up to `ticks` for a notification. Outside any task (main()) it just
+// sleeps, as nothing can notify it.
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  NativeTask *self = nativeCurrentTask();
+  if (!self) {
+    delay(ticks);
+    return 0;
+  }
+  const uint64_t waitUs = (uint64_t)ticks * portTICK_PERIOD_MS * 1000ULL;
+  if (NativeClock::scheduler()) {
+    // Coroutines share one thread, so the count needs no waiting on the lock.
+    if (!self->count) NativeClock::scheduler()->sleepUs(waitUs);
+  } else {
+    std::unique_lock<std::mutex> guard(self->lock);
+    self->notified.wait_for(guard, std::chrono::microseconds(waitUs), [self] { return self->count != 0; });
+  }
+  std::lock_guard<std::mutex> guard(self->lock);
+  const uint32_t value = self->count;
+  if (clearOnExit) {
+    self->count = 0;
+  } else if (self->count) {
+    self->count--;
+  }
+  return value;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+// Matches the ESP32 ROM routine: reflected CRC-32 (poly 0xEDB88320) with the
+// running value inverted on entry and exit, so calls can be chained.
+inline uint32_t crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (uint8_t bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+// The slice of the ESP32 ROM's miniz inflater the firmware uses, implemented
+// over the host's zlib. Same calling convention as tinfl: the caller owns a
+// 32 KB power-of-two output ring and gets back bytes consumed and produced.
+// zlib keeps its own state and window inside the decompressor struct, so on
+// the host it is ~48 KB rather than the ROM's ~11 KB.
+
+typedef unsigned char mz_uint8;
+typedef unsigned int mz_uint32;
+typedef uint64_t tinfl_bit_buf_t;
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+enum {
+  TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+  TINFL_FLAG_HAS_MORE_INPUT = 2,
+  TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+  TINFL_FLAG_COMPUTE_ADLER32 = 8
+};
+
+typedef enum {
+  TINFL_STATUS_BAD_PARAM = -3,
+  TINFL_STATUS_ADLER32_MISMATCH = -2,
+  TINFL_STATUS_FAILED = -1,
+  TINFL_STATUS_DONE = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+struct tinfl_decompressor {
+  mz_uint32 m_state;
+  mz_uint32 m_num_bits;
+  tinfl_bit_buf_t m_bit_buf;
+  // Host only: zlib stream plus a bump arena for its allocations, so a caller
+  // that frees the struct without a teardown call leaks nothing.
+  z_stream zs;
+  size_t arenaUsed;
+  alignas(16) uint8_t arena[48 * 1024];
+};
+
+#define tinfl_init(r) \
+  do {                \
+    (r)->m_state = 0; \
+  } while (0)
+
+inline voidpf tinflArenaAlloc(voidpf opaque, uInt items, uInt size) {
+  tinfl_decompressor *r = (tinfl_decompressor *)opaque;
+  const size_t bytes = ((size_t)items * size + 15) & ~(size_t)15;
+  if (r->arenaUsed + bytes > sizeof(r->arena)) return Z_NULL;
+  voidpf p = r->arena + r->arenaUsed;
+  r->arenaUsed += bytes;
+  return p;
+}
+
+inline void tinflArenaFree(voidpf, voidpf) {}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor *r,
+                                     const mz_uint8 *pIn_buf_next,
+                                     size_t *pIn_buf_size,
+                                     mz_uint8 *pOut_buf_start,
+                                     mz_uint8 *pOut_buf_next,
+                                     size_t *pOut_buf_size,
+                                     const mz_uint32 decomp_flags) {
+  (void)pOut_buf_start;
+  if (r->m_state == 0) {
+    r->m_num_bits = 0;
+    r->m_bit_buf = 0;
+    r->arenaUsed = 0;
+    r->zs = z_stream();
+    r->zs.zalloc = tinflArenaAlloc;
+    r->zs.zfree = tinflArenaFree;
+    r->zs.opaque = r;
+    const int windowBits = (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15;
+    if (inflateInit2(&r->zs, windowBits) != Z_OK) return TINFL_STATUS_FAILED;
+    r->m_state = 1;
+  }
+  if (r->m_state == 2) {
+    *pIn_buf_size = 0;
+    *pOut_buf_size = 0;
+    return TINFL_STATUS_DONE;
+  }
+
+  r->zs.next_in = (Bytef *)pIn_buf_next;
+  r->zs.avail_in = (uInt)*pIn_buf_size;
+  r->zs.next_out = pOut_buf_next;
+  r->zs.avail_out = (uInt)*pOut_buf_size;
+  const int ret = inflate(&r->zs, Z_NO_FLUSH);
+  *pIn_buf_size -= r->zs.avail_in;
+  *pOut_buf_size -= r->zs.avail_out;
+
+  if (ret == Z_STREAM_END) {
+    r->m_state = 2;
+    return TINFL_STATUS_DONE;
+  }
+  if (ret == Z_DATA_ERROR && r->zs.msg && strstr(r->zs.msg, "incorrect data check")) {
+    return TINFL_STATUS_ADLER32_MISMATCH;
+  }
+  if (ret != Z_OK && ret != Z_BUF_ERROR) return TINFL_STATUS_FAILED;
+  if (r->zs.avail_out == 0) return TINFL_STATUS_HAS_MORE_OUTPUT;
+  return (decomp_flags & TINFL_FLAG_HAS_MORE_INPUT) ? TINFL_STATUS_NEEDS_MORE_INPUT : TINFL_STATUS_FAILED;
+}
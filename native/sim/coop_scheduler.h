@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ucontext.h>
+
+#include <memory>
+#include <vector>
+
+// Deterministic stand-in for FreeRTOS on one host thread. Every task is a
+// ucontext coroutine; time is virtual and jumps straight to the earliest
+// wake-up whenever the running task sleeps, so days of firmware time replay in
+// seconds and identical inputs always interleave the same way.
+class CoopScheduler : public NativeClock::Scheduler {
+public:
+  static const size_t kTaskStackBytes = 512 * 1024;
+
+  // The calling thread becomes task 0.
+  CoopScheduler() { _tasks.emplace_back(new Task()); }
+
+  uint64_t nowUs() override { return _nowUs; }
+
+  void sleepUs(uint64_t us) override {
+    _tasks[_current]->wakeUs = _nowUs + us;
+    switchToNext();
+  }
+
+  void spawn(void (*fn)(void *), void *arg) override {
+    Task *t = new Task();
+    t->fn = fn;
+    t->arg = arg;
+    t->wakeUs = _nowUs;
+    t->stack.reset(new char[kTaskStackBytes]);
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack.get();
+    t->ctx.uc_stack.ss_size = kTaskStackBytes;
+    t->ctx.uc_link = nullptr;
+    makecontext(&t->ctx, (void (*)())trampoline, 0);
+    _tasks.emplace_back(t);
+  }
+
+  void *&taskLocal() override { return _tasks[_current]->local; }
+
+  void wake(void *local) override {
+    for (std::unique_ptr<Task> &t : _tasks) {
+      if (t->local == local && t->wakeUs > _nowUs) t->wakeUs = _nowUs;
+    }
+  }
+
+private:
+  struct Task {
+    ucontext_t ctx;
+    std::unique_ptr<char[]> stack;
+    void (*fn)(void *) = nullptr;
+    void *arg = nullptr;
+    void *local = nullptr;
+    uint64_t wakeUs = 0;
+    bool live = true;
+  };
+
+  std::vector<std::unique_ptr<Task>> _tasks;
+  size_t _current = 0;
+  uint64_t _nowUs = 0;
+
+  static void trampoline() {
+    CoopScheduler *self = static_cast<CoopScheduler *>(NativeClock::scheduler());
+    Task &t = *self->_tasks[self->_current];
+    t.fn(t.arg);
+    t.live = false;
+    self->switchToNext();
+  }
+
+  // Earliest wake-up wins; ties go round-robin from the task after this one.
+  void switchToNext() {
+    const size_t n = _tasks.size();
+    size_t next = _current;
+    bool found = false;
+    for (size_t i = 1; i <= n; ++i) {
+      const size_t idx = (_current + i) % n;
+      const Task &t = *_tasks[idx];
+      if (!t.live) continue;
+      if (!found || t.wakeUs < _tasks[next]->wakeUs) {
+        next = idx;
+        found = true;
+      }
+    }
+    if (!found) abort();  // every task has returned
+
+    if (_tasks[next]->wakeUs > _nowUs) _nowUs = _tasks[next]->wakeUs;
+    if (next == _current) return;
+    const size_t prev = _current;
+    _current = next;
+    swapcontext(&_tasks[prev]->ctx, &_tasks[next]->ctx);
+  }
+};
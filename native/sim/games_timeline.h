@@ -0,0 +1,234 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic Winter Games: a schedule of sessions across the fortnight and the
+// medals each medal session hands out, released into the feeds a few minutes
+// after it ends. Renders the medals-country, medals-sport and schedule
+// responses as they would read at any instant, and keeps the favourite's
+// medals as ground truth for alert accounting.
+class GamesTimeline {
+public:
+  struct Sport {
+    const char *code;
+    const char *name;
+  };
+
+  struct Session {
+    time_t startEpoch;
+    time_t endEpoch;
+    uint8_t sport;
+    bool medal;
+    std::string title;
+  };
+
+  struct Award {
+    time_t feedEpoch;  // first instant the feeds include it
+    uint8_t sport;
+    uint8_t medal;     // 0 gold, 1 silver, 2 bronze
+    uint8_t country;
+  };
+
+  // `favorites` is a comma-separated NOC list, as in FOCUS_TEAM_ABBRS.
+  GamesTimeline(const char *favorites, time_t startEpoch, uint8_t days, uint32_t seed)
+      : _startEpoch(startEpoch), _days(days) {
+    _countries = {"NOR", "GER", "USA", "CAN", "NED", "SWE", "AUT", "SUI", "FRA", "ITA",
+                  "JPN", "KOR", "CHN", "FIN", "SLO", "CZE", "POL", "GBR", "AUS", "NZL",
+                  "LAT", "BEL", "EST", "ESP", "UKR", "KAZ", "SVK", "BUL", "DEN", "HUN"};
+    std::string list(favorites);
+    for (size_t pos = 0; pos <= list.size();) {
+      size_t end = list.find(',', pos);
+      if (end == std::string::npos) end = list.size();
+      std::string code = list.substr(pos, end - pos);
+      pos = end + 1;
+      for (char &c : code) c = (char)toupper((unsigned char)c);
+      if (code.empty()) continue;
+      auto fav = std::find(_countries.begin(), _countries.end(), code);
+      if (fav == _countries.end()) {
+        _countries.push_back(code);
+        fav = _countries.end() - 1;
+      }
+      _favorites.push_back((uint8_t)(fav - _countries.begin()));
+    }
+    generate(seed);
+  }
+
+  static const std::vector<Sport> &sports() {
+    static const std::vector<Sport> list = {
+      {"ALP", "Alpine Skiing"}, {"BTH", "Biathlon"},          {"BOB", "Bobsled"},
+      {"CCS", "Cross-Country Skiing"}, {"CUR", "Curling"},     {"FSK", "Figure Skating"},
+      {"FRS", "Freestyle Skiing"}, {"IHO", "Hockey"},         {"LUG", "Luge"},
+      {"NCB", "Nordic Combined"}, {"SBD", "Snowboarding"},    {"SKN", "Skeleton"},
+      {"SJP", "Ski Jumping"},  {"SMT", "Ski Mountaineering"}, {"SSK", "Speed Skating"},
+      {"STK", "Short Track"},
+    };
+    return list;
+  }
+
+  time_t startEpoch() const { return _startEpoch; }
+  time_t endEpoch() const { return _startEpoch + (time_t)_days * 86400; }
+  const std::vector<Award> &awards() const { return _awards; }
+  bool isFavorite(const Award &a) const {
+    return std::find(_favorites.begin(), _favorites.end(), a.country) != _favorites.end();
+  }
+  const std::string &countryCode(uint8_t country) const { return _countries[country]; }
+
+  std::string medalsCountryJson(time_t now) const {
+    std::vector<Tally> tallies = talliesAt(now, -1);
+    std::string out = "[";
+    for (size_t i = 0; i < tallies.size(); ++i) {
+      if (i) out += ",";
+      appendRow(out, tallies[i], (int)i + 1);
+    }
+    return out + "]";
+  }
+
+  // Empty for unknown sport codes.
+  std::string medalsSportJson(const std::string &code, time_t now) const {
+    int sport = -1;
+    for (size_t i = 0; i < sports().size(); ++i) {
+      if (code == sports()[i].code) sport = (int)i;
+    }
+    if (sport < 0) return std::string();
+    std::vector<Tally> tallies = talliesAt(now, sport);
+    std::string out = "[";
+    int rank = 0;
+    for (const Tally &t : tallies) {
+      if (t.total() == 0) continue;
+      if (rank) out += ",";
+      appendRow(out, t, ++rank);
+    }
+    return out + "]";
+  }
+
+  // Sessions whose local start date (per the current TZ) is `ymd`, which may
+  // be dashed or compact.
+  std::string scheduleJson(std::string ymd, time_t now) const {
+    ymd.erase(std::remove(ymd.begin(), ymd.end(), '-'), ymd.end());
+    std::string out = "{\"data\":[";
+    bool first = true;
+    for (const Session &s : _sessions) {
+      struct tm lt;
+      localtime_r(&s.startEpoch, &lt);
+      char day[12];
+      strftime(day, sizeof(day), "%Y%m%d", &lt);
+      if (ymd != day) continue;
+
+      const char *status = (now < s.startEpoch) ? "upcoming" : (now < s.endEpoch) ? "live" : "final";
+      const Sport &sp = sports()[s.sport];
+      char item[512];
+      snprintf(item,
+               sizeof(item),
+               "%s{\"singleEvent\":{\"title\":\"%s\",\"shortTitle\":\"%s\",\"startDate\":%ld,"
+               "\"status\":\"%s\",\"isMedalSession\":%s,\"gameType\":\"olympics\"},"
+               "\"sports\":[{\"code\":\"%s\",\"shortDisplayTitle\":\"%s\",\"title\":\"%s\"}]}",
+               first ? "" : ",",
+               s.title.c_str(),
+               s.title.c_str(),
+               (long)s.startEpoch,
+               status,
+               s.medal ? "true" : "false",
+               sp.code,
+               sp.name,
+               sp.name);
+      out += item;
+      first = false;
+    }
+    return out + "]}";
+  }
+
+private:
+  struct Tally {
+    uint8_t country;
+    uint16_t medals[3];
+    uint16_t total() const { return medals[0] + medals[1] + medals[2]; }
+  };
+
+  time_t _startEpoch;
+  uint8_t _days;
+  std::vector<std::string> _countries;
+  std::vector<uint8_t> _favorites;
+  std::vector<Session> _sessions;
+  std::vector<Award> _awards;
+
+  // With one favourite no extra number is drawn, so single-favourite runs
+  // replay the same Games for a given seed.
+  template <typename Pick>
+  uint8_t pickFavorite(Pick &pick) const {
+    if (_favorites.empty()) return (uint8_t)pick((uint32_t)_countries.size());
+    return _favorites.size() == 1 ? _favorites[0] : _favorites[pick((uint32_t)_favorites.size())];
+  }
+
+  void generate(uint32_t seed) {
+    std::mt19937 rng(seed);
+    auto pick = [&rng](uint32_t n) { return (uint32_t)(rng() % n); };
+    static const char *kPhases[] = {"Qualification", "Heats", "Semifinal", "Final", "Medal Round"};
+    static const char *kFields[] = {"Men's", "Women's", "Mixed"};
+
+    for (uint8_t day = 0; day < _days; ++day) {
+      const time_t dayStart = _startEpoch + (time_t)day * 86400;
+      const uint32_t sessions = 12 + pick(8);
+      for (uint32_t i = 0; i < sessions; ++i) {
+        Session s;
+        s.startEpoch = dayStart + 9 * 3600 + (time_t)pick(13 * 12) * 300;
+        s.endEpoch = s.startEpoch + 3600 + (time_t)pick(5) * 1800;
+        s.sport = (uint8_t)pick((uint32_t)sports().size());
+        s.medal = pick(100) < 45;
+        s.title = std::string(kFields[pick(3)]) + " " + kPhases[s.medal ? 3 + pick(2) : pick(3)];
+        _sessions.push_back(s);
+
+        if (!s.medal) continue;
+        // Results reach the medal feeds 3-12 minutes after the session ends.
+        const time_t feedEpoch = s.endEpoch + 180 + (time_t)pick(10) * 60;
+        for (uint8_t medal = 0; medal < 3; ++medal) {
+          const uint8_t country = (pick(100) < 12) ? pickFavorite(pick) : (uint8_t)pick((uint32_t)_countries.size());
+          _awards.push_back({feedEpoch, s.sport, medal, country});
+        }
+      }
+    }
+    std::sort(_sessions.begin(), _sessions.end(), [](const Session &a, const Session &b) {
+      return a.startEpoch < b.startEpoch;
+    });
+    std::stable_sort(_awards.begin(), _awards.end(), [](const Award &a, const Award &b) {
+      return a.feedEpoch < b.feedEpoch;
+    });
+  }
+
+  std::vector<Tally> talliesAt(time_t now, int sport) const {
+    std::vector<Tally> tallies(_countries.size());
+    for (size_t i = 0; i < tallies.size(); ++i) tallies[i] = {(uint8_t)i, {0, 0, 0}};
+    for (const Award &a : _awards) {
+      if (a.feedEpoch > now) break;
+      if (sport >= 0 && a.sport != sport) continue;
+      tallies[a.country].medals[a.medal]++;
+    }
+    std::stable_sort(tallies.begin(), tallies.end(), [](const Tally &a, const Tally &b) {
+      if (a.medals[0] != b.medals[0]) return a.medals[0] > b.medals[0];
+      if (a.medals[1] != b.medals[1]) return a.medals[1] > b.medals[1];
+      return a.medals[2] > b.medals[2];
+    });
+    return tallies;
+  }
+
+  void appendRow(std::string &out, const Tally &t, int rank) const {
+    const std::string &code = _countries[t.country];
+    char row[256];
+    snprintf(row,
+             sizeof(row),
+             "{\"countryCode\":\"%s\",\"countryName\":\"Country %s\",\"gold\":%u,\"silver\":%u,"
+             "\"bronze\":%u,\"medalTotal\":%u,\"medalRank\":%d}",
+             code.c_str(),
+             code.c_str(),
+             (unsigned)t.medals[0],
+             (unsigned)t.medals[1],
+             (unsigned)t.medals[2],
+             (unsigned)t.total(),
+             rank);
+    out += row;
+  }
+};
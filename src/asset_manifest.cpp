@@ -0,0 +1,109 @@
+#include "asset_manifest.h"
+
+#include <SPIFFS.h>
+
+namespace {
+
+static const char *kFlagDir = "/flags";
+
+}  // namespace
+
+AssetManifest::Entry AssetManifest::makeEntry(const String &code, int16_t size) {
+  Entry e;
+  e.code = 0;
+  for (uint8_t i = 0; i < 4; ++i) {
+    e.code = (e.code << 8) | (uint8_t)(i < code.length() ? code[i] : 0);
+  }
+  e.size = (uint16_t)size;
+  return e;
+}
+
+uint16_t AssetManifest::lowerBound(const Entry &key) const {
+  uint16_t lo = 0;
+  uint16_t hi = _count;
+  while (lo < hi) {
+    const uint16_t mid = (uint16_t)((lo + hi) / 2);
+    if (less(_entries[mid], key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+bool AssetManifest::contains(const String &code, int16_t size) const {
+  if (!tracks(code)) return false;
+  const Entry key = makeEntry(code, size);
+  const uint16_t i = lowerBound(key);
+  return i < _count && !less(key, _entries[i]);
+}
+
+void AssetManifest::add(const String &code, int16_t size) {
+  if (!tracks(code)) return;
+  const Entry key = makeEntry(code, size);
+  const uint16_t i = lowerBound(key);
+  if (i < _count && !less(key, _entries[i])) return;
+  if (_count == kMaxEntries) {
+    // Lookups can no longer be trusted to mean "absent".
+    _complete = false;
+    return;
+  }
+  memmove(&_entries[i + 1], &_entries[i], (_count - i) * sizeof(Entry));
+  _entries[i] = key;
+  _count++;
+}
+
+void AssetManifest::remove(const String &code, int16_t size) {
+  if (!tracks(code)) return;
+  const Entry key = makeEntry(code, size);
+  const uint16_t i = lowerBound(key);
+  if (i >= _count || less(key, _entries[i])) return;
+  memmove(&_entries[i], &_entries[i + 1], (_count - i - 1) * sizeof(Entry));
+  _count--;
+}
+
+bool AssetManifest::parsePath(const String &path, String &code, int16_t &size) {
+  const String prefix = String(kFlagDir) + "/";
+  if (!path.startsWith(prefix) || !path.endsWith(".png")) return false;
+  String rest = path.substring(prefix.length(), path.length() - 4);
+  size = 0;
+  const int slash = rest.indexOf('/');
+  if (slash >= 0) {
+    size = (int16_t)rest.substring(0, slash).toInt();
+    if (size <= 0) return false;
+    rest = rest.substring(slash + 1);
+  }
+  if (rest.indexOf('/') >= 0 || !tracks(rest)) return false;
+  code = rest;
+  return true;
+}
+
+void AssetManifest::addPath(const String &path) {
+  String code;
+  int16_t size = 0;
+  if (parsePath(path, code, size)) add(code, size);
+}
+
+bool AssetManifest::build() {
+  _count = 0;
+  _complete = true;
+  File dir = SPIFFS.open(kFlagDir);
+  if (!dir || !dir.isDirectory()) {
+    // Nothing cached yet is still a complete answer.
+    return true;
+  }
+  // SPIFFS lists nested names flat; a filesystem with real directories
+  // needs the size folders opened one by one.
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    if (f.isDirectory()) {
+      File sub = SPIFFS.open(f.path());
+      for (File g = sub.openNextFile(); g; g = sub.openNextFile()) addPath(g.path());
+      sub.close();
+    } else {
+      addPath(f.path());
+    }
+  }
+  dir.close();
+  return _complete;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Which flag files SPIFFS holds, so an existence check is a binary search in
+// RAM instead of a scan of the SPIFFS object table. Keys are (code, size);
+// size 0 stands for the flat /flags/<code>.png fallback. Built once from a
+// directory listing, then kept in step by whoever writes or removes a flag.
+class AssetManifest {
+public:
+  static const uint16_t kMaxEntries = 512;
+
+  // Lists /flags on the mounted SPIFFS. Returns false if the listing failed
+  // or overflowed, in which case the manifest stays incomplete.
+  bool build();
+
+  // Codes longer than four characters are never tracked; ask SPIFFS.
+  static bool tracks(const String &code) { return code.length() > 0 && code.length() <= 4; }
+
+  // Only meaningful while complete(); check before trusting a miss.
+  bool contains(const String &code, int16_t size) const;
+  void add(const String &code, int16_t size);
+  void remove(const String &code, int16_t size);
+
+  bool complete() const { return _complete; }
+  uint16_t count() const { return _count; }
+
+  // "/flags/56/CAN.png" -> ("CAN", 56), "/flags/CAN.png" -> ("CAN", 0).
+  static bool parsePath(const String &path, String &code, int16_t &size);
+
+private:
+  struct Entry {
+    uint32_t code;
+    uint16_t size;
+  };
+
+  static Entry makeEntry(const String &code, int16_t size);
+  static bool less(const Entry &a, const Entry &b) {
+    return a.code != b.code ? a.code < b.code : a.size < b.size;
+  }
+  uint16_t lowerBound(const Entry &key) const;
+  void addPath(const String &path);
+
+  Entry _entries[kMaxEntries];
+  uint16_t _count = 0;
+  bool _complete = false;
+};
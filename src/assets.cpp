@@ -1,6 +1,9 @@
 #include "assets.h"
 #include "palette.h"
 #include "config.h"
+#include "asset_manifest.h"
+#include "flag_atlas.h"
+#include "flag_tile_cache.h"
 
 #include <SPI.h>
 #include <SPIFFS.h>
@@ -9,6 +12,9 @@
 #include <HTTPClient.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
 
 namespace {
 
@@ -27,9 +33,16 @@ int16_t g_drawY = 0;
 uint16_t g_line[320];
 uint16_t g_lineScaled[320];
 
-int16_t g_targetSize = 0;
 int16_t g_scaleDiv = 1;
 
+// When set, decoded rows go into this tile instead of straight to the panel.
+uint16_t *g_capture = nullptr;
+int16_t g_captureW = 0;
+int16_t g_captureH = 0;
+
+FlagTileCache g_flagTiles;
+AssetManifest g_manifest;
+
 bool g_spiffsReady = false;
 bool g_sdReady = false;
 
@@ -41,6 +54,52 @@ constexpr uint32_t SD_SPI_HZ_FALLBACK = 1000000;
 constexpr size_t FLAG_MAX_BYTES = 120 * 1024;
 constexpr int16_t kFlagCacheSizes[] = {56, 64, 96};
 
+// Flags wanted by the renderer or the latest medal table, downloaded by a
+// low-priority task so a draw never waits on HTTPS.
+constexpr uint8_t kPrefetchSlots = 32;
+// Failed downloads back off 2, 4, 8 and 16 minutes; after the fifth failure
+// the flag is given up for kPrefetchGiveUpMs and its slot may be reclaimed.
+constexpr uint32_t kPrefetchRetryMs = 2UL * 60UL * 1000UL;
+constexpr uint8_t kPrefetchMaxFailures = 5;
+constexpr uint32_t kPrefetchGiveUpMs = 6UL * 3600UL * 1000UL;
+constexpr uint32_t kPrefetchIdleMs = 30000;
+constexpr uint32_t kPrefetchWaitMs = 5000;
+// A TLS session needs its record buffers in one piece; leave the rest of the
+// heap to the feed parser.
+constexpr size_t kPrefetchHeapBytes = 48 * 1024;
+constexpr uint32_t kPrefetchTaskStack = 8 * 1024;
+
+struct PrefetchSlot {
+  bool used = false;
+  // Being downloaded; never reclaimed meanwhile.
+  bool busy = false;
+  uint8_t failures = 0;
+  int16_t size = 0;
+  uint32_t retryAtMs = 0;
+  char code[5] = {};
+  char url[128] = {};
+
+  bool gaveUp() const { return failures >= kPrefetchMaxFailures; }
+  bool due(uint32_t nowMs) const { return !failures || (int32_t)(retryAtMs - nowMs) <= 0; }
+};
+
+PrefetchSlot g_prefetch[kPrefetchSlots];
+TaskHandle_t g_prefetchTask = nullptr;
+std::atomic<uint32_t> g_flagGeneration{0};
+
+// Guards g_manifest and g_prefetch, which the prefetch task writes while the
+// UI reads them. Held only for the lookup or update, never across I/O.
+SemaphoreHandle_t g_lock = nullptr;
+
+struct Lock {
+  Lock() {
+    if (g_lock) xSemaphoreTake(g_lock, portMAX_DELAY);
+  }
+  ~Lock() {
+    if (g_lock) xSemaphoreGive(g_lock);
+  }
+};
+
 bool tryBeginSd(SPIClass &bus, const char *busName, uint32_t hz) {
   bus.begin(SD_SCLK, SD_MISO, SD_MOSI, SD_CS);
   const bool ok = SD.begin(SD_CS, bus, hz);
@@ -82,13 +141,13 @@ int pngDraw(PNGDRAW *pDraw) {
   // TFT_eSPI expects big-endian RGB565 pixel order when swap-bytes is disabled.
   g_png.getLineAsRGB565(pDraw, g_line, PNG_RGB565_BIG_ENDIAN, 0x00000000);
 
-  if (g_targetSize > 0) {
-    if (pDraw->y == 0) {
-      g_scaleDiv = (int16_t)((pDraw->iWidth + g_targetSize - 1) / g_targetSize);
-      if (g_scaleDiv < 1) g_scaleDiv = 1;
-    }
-  } else {
-    g_scaleDiv = 1;
+  if (g_capture) {
+    if ((pDraw->y % g_scaleDiv) != 0) return 1;
+    const int16_t row = (int16_t)(pDraw->y / g_scaleDiv);
+    if (row >= g_captureH) return 1;
+    uint16_t *out = &g_capture[row * g_captureW];
+    for (int16_t i = 0; i < g_captureW; ++i) out[i] = g_line[i * g_scaleDiv];
+    return 1;
   }
 
   if (g_scaleDiv <= 1) {
@@ -112,21 +171,43 @@ int pngDraw(PNGDRAW *pDraw) {
   return 1;
 }
 
-bool drawPngFromFs(fs::FS &fs, const String &path, int16_t x, int16_t y, int16_t targetSize = 0) {
+// A non-empty cacheCode decodes into a tile of the flag cache and pushes it
+// whole; without one, or if the tile can't be had, rows go to the panel.
+bool drawPngFromFs(fs::FS &fs,
+                   const String &path,
+                   int16_t x,
+                   int16_t y,
+                   int16_t targetSize = 0,
+                   const char *cacheCode = nullptr) {
   if (!g_tft) return false;
 
   g_fs = &fs;
   g_drawX = x;
   g_drawY = y;
-  g_targetSize = targetSize;
-  g_scaleDiv = 1;
 
   const int rcOpen = g_png.open((char *)path.c_str(), pngOpen, pngClose, pngRead, pngSeek, pngDraw);
   if (rcOpen != 0) return false;
 
+  // Integer downsample, to keep small medal-table flags legible.
+  const int16_t srcW = (int16_t)g_png.getWidth();
+  const int16_t srcH = (int16_t)g_png.getHeight();
+  g_scaleDiv = (targetSize > 0) ? max((int16_t)1, (int16_t)((srcW + targetSize - 1) / targetSize)) : 1;
+  if (cacheCode && *cacheCode && targetSize > 0) {
+    g_captureW = min((int16_t)((srcW + g_scaleDiv - 1) / g_scaleDiv), (int16_t)(sizeof(g_line) / sizeof(g_line[0])));
+    g_captureH = (int16_t)((srcH + g_scaleDiv - 1) / g_scaleDiv);
+    g_capture = g_flagTiles.reserve(cacheCode, targetSize, g_captureW, g_captureH);
+  }
+
   const int rcDec = g_png.decode(nullptr, 0);
   g_png.close();
-  g_targetSize = 0;
+  if (g_capture) {
+    if (rcDec == 0) {
+      g_tft->pushImage(x, y, g_captureW, g_captureH, g_capture);
+    } else {
+      g_flagTiles.drop(cacheCode, targetSize);
+    }
+  }
+  g_capture = nullptr;
   g_scaleDiv = 1;
   return (rcDec == 0);
 }
@@ -140,13 +221,58 @@ String makeFlagFlatPath(const String &abbr) {
   return String("/flags/") + abbr + ".png";
 }
 
+// Size 0 is the flat fallback. Answered from the manifest whenever it can;
+// SPIFFS.exists scans the whole object table.
+bool flagExists(const String &abbr, int16_t size) {
+  {
+    Lock lock;
+    if (g_manifest.complete() && AssetManifest::tracks(abbr)) return g_manifest.contains(abbr, size);
+  }
+  return SPIFFS.exists(size ? makeFlagSizePath(size, abbr) : makeFlagFlatPath(abbr));
+}
+
+bool fileExists(const String &path) {
+  String code;
+  int16_t size = 0;
+  if (AssetManifest::parsePath(path, code, size)) {
+    Lock lock;
+    if (g_manifest.complete()) return g_manifest.contains(code, size);
+  }
+  return SPIFFS.exists(path);
+}
+
+// Every write or removal under /flags goes through here to keep the
+// manifest in step.
+void noteFlagFile(const String &path, bool present) {
+  String code;
+  int16_t size = 0;
+  if (!AssetManifest::parsePath(path, code, size)) return;
+  Lock lock;
+  if (present) {
+    g_manifest.add(code, size);
+  } else {
+    g_manifest.remove(code, size);
+  }
+}
+
+void removeFile(const String &path) {
+  SPIFFS.remove(path);
+  noteFlagFile(path, false);
+}
+
 bool hasAnySizedFlagCache(const String &abbr) {
   for (int16_t cachedSize : kFlagCacheSizes) {
-    if (SPIFFS.exists(makeFlagSizePath(cachedSize, abbr))) return true;
+    if (flagExists(abbr, cachedSize)) return true;
   }
   return false;
 }
 
+// Any copy drawLogoImpl can decode: the requested size, another cached size
+// or the flat file.
+bool hasDrawableFlag(const String &abbr, int16_t size) {
+  return flagExists(abbr, size) || hasAnySizedFlagCache(abbr) || flagExists(abbr, 0);
+}
+
 bool ensureSpiffsDir(const String &dirPath) {
   if (!g_spiffsReady) return false;
   if (dirPath.length() == 0 || dirPath == "/") return true;
@@ -244,14 +370,14 @@ bool downloadToSpiffs(const String &url, const String &destPath, size_t maxBytes
     total += (size_t)readN;
     if (total > maxBytes) {
       out.close();
-      SPIFFS.remove(destPath);
+      removeFile(destPath);
       http.end();
       return false;
     }
 
     if (out.write(buf, (size_t)readN) != (size_t)readN) {
       out.close();
-      SPIFFS.remove(destPath);
+      removeFile(destPath);
       http.end();
       return false;
     }
@@ -263,15 +389,16 @@ bool downloadToSpiffs(const String &url, const String &destPath, size_t maxBytes
   http.end();
 
   if (total == 0) {
-    SPIFFS.remove(destPath);
+    removeFile(destPath);
     return false;
   }
 
+  noteFlagFile(destPath, true);
   return true;
 }
 
 bool copySpiffsFile(const String &src, const String &dst) {
-  if (!SPIFFS.exists(src)) return false;
+  if (!fileExists(src)) return false;
 
   const int slash = dst.lastIndexOf('/');
   if (slash > 0) {
@@ -294,13 +421,14 @@ bool copySpiffsFile(const String &src, const String &dst) {
     if (out.write(buf, n) != n) {
       in.close();
       out.close();
-      SPIFFS.remove(dst);
+      removeFile(dst);
       return false;
     }
   }
 
   in.close();
   out.close();
+  noteFlagFile(dst, true);
   return true;
 }
 
@@ -309,9 +437,7 @@ bool ensureFlagCached(const String &abbr, const String &logoUrl, int16_t size) {
 
   const String sizedPath = makeFlagSizePath(size, abbr);
   const String flatPath = makeFlagFlatPath(abbr);
-  if (SPIFFS.exists(sizedPath)) return true;
-  if (hasAnySizedFlagCache(abbr)) return true;
-  if (SPIFFS.exists(flatPath)) return true;
+  if (hasDrawableFlag(abbr, size)) return true;
   if (!logoUrl.length()) return false;
 
   // Prefer a size-specific cached PNG even when a legacy flat cache exists.
@@ -319,18 +445,120 @@ bool ensureFlagCached(const String &abbr, const String &logoUrl, int16_t size) {
 
   const String sizedUrl = rewriteEspnLogoUrlForSize(logoUrl, size);
   if (downloadToSpiffs(sizedUrl, sizedPath, FLAG_MAX_BYTES)) {
-    if (!SPIFFS.exists(flatPath)) {
+    if (!flagExists(abbr, 0)) {
       copySpiffsFile(sizedPath, flatPath);
     }
     return true;
   }
 
-  if (!SPIFFS.exists(flatPath) && downloadToSpiffs(logoUrl, flatPath, FLAG_MAX_BYTES)) {
+  if (!flagExists(abbr, 0) && downloadToSpiffs(logoUrl, flatPath, FLAG_MAX_BYTES)) {
     copySpiffsFile(flatPath, sizedPath);
     return true;
   }
 
-  return SPIFFS.exists(sizedPath) || SPIFFS.exists(flatPath);
+  return flagExists(abbr, size) || flagExists(abbr, 0);
+}
+
+// Safe from any task; the download happens on the prefetch task.
+void queuePrefetch(const String &abbr, const String &logoUrl, int16_t size) {
+  if (!g_prefetchTask || !AssetManifest::tracks(abbr) || size <= 0) return;
+  if (!logoUrl.length() || logoUrl.length() >= sizeof(PrefetchSlot::url)) return;
+  if (hasDrawableFlag(abbr, size)) return;
+
+  {
+    Lock lock;
+    const uint32_t now = millis();
+    PrefetchSlot *target = nullptr;
+    PrefetchSlot *failedSlot = nullptr;
+    for (PrefetchSlot &slot : g_prefetch) {
+      if (!slot.used) {
+        if (!target) target = &slot;
+        continue;
+      }
+      if (slot.size == size && abbr == slot.code) {
+        // Queued already, or given up and not yet due another try.
+        if (!slot.gaveUp() || !slot.due(now)) return;
+        target = &slot;
+        break;
+      }
+      if (!slot.busy && slot.failures && (!failedSlot || slot.failures > failedSlot->failures)) {
+        failedSlot = &slot;
+      }
+    }
+    // Full: a live request takes the slot of the flag that failed most, so
+    // dead URLs can't starve new countries. Otherwise the next table asks again.
+    if (!target) target = failedSlot;
+    if (!target) return;
+    target->used = true;
+    target->busy = false;
+    target->failures = 0;
+    target->size = size;
+    target->retryAtMs = 0;
+    strlcpy(target->code, abbr.c_str(), sizeof(target->code));
+    strlcpy(target->url, logoUrl.c_str(), sizeof(target->url));
+  }
+  xTaskNotifyGive(g_prefetchTask);
+}
+
+// Drains g_prefetch one flag at a time. Waits while Wi-Fi is down or the heap
+// can't hold a TLS session; a failed flag backs off, then is given up.
+void prefetchTask(void *) {
+  for (;;) {
+    PrefetchSlot job;
+    int8_t index = -1;
+    const uint32_t now = millis();
+    {
+      Lock lock;
+      for (uint8_t i = 0; i < kPrefetchSlots; ++i) {
+        PrefetchSlot &slot = g_prefetch[i];
+        if (!slot.used || slot.gaveUp() || !slot.due(now)) continue;
+        slot.busy = true;
+        job = slot;
+        index = (int8_t)i;
+        break;
+      }
+    }
+
+    if (index < 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kPrefetchIdleMs));
+      continue;
+    }
+    if (WiFi.status() != WL_CONNECTED || ESP.getMaxAllocHeap() < kPrefetchHeapBytes) {
+      {
+        Lock lock;
+        g_prefetch[index].busy = false;
+      }
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kPrefetchWaitMs));
+      continue;
+    }
+
+    const bool ok = ensureFlagCached(String(job.code), String(job.url), job.size);
+    uint8_t failures = 0;
+    uint32_t retryMs = 0;
+    {
+      // A busy slot is never reclaimed, so index still names the job.
+      Lock lock;
+      PrefetchSlot &slot = g_prefetch[index];
+      slot.busy = false;
+      if (ok) {
+        slot.used = false;
+      } else {
+        failures = ++slot.failures;
+        retryMs = slot.gaveUp() ? kPrefetchGiveUpMs : kPrefetchRetryMs << (failures - 1);
+        slot.retryAtMs = millis() + retryMs;
+      }
+    }
+    if (ok) {
+      g_flagGeneration.fetch_add(1);
+    } else {
+      Serial.printf("ASSETS: flag %s download failed (%u/%u), %s %lus\n",
+                    job.code,
+                    (unsigned)failures,
+                    (unsigned)kPrefetchMaxFailures,
+                    failures >= kPrefetchMaxFailures ? "giving up for" : "retry in",
+                    (unsigned long)(retryMs / 1000UL));
+    }
+  }
 }
 
 void drawFallbackBadge(int16_t x, int16_t y, int size, const char *label) {
@@ -348,43 +576,61 @@ void drawFallbackBadge(int16_t x, int16_t y, int size, const char *label) {
   }
 }
 
-void drawLogoImpl(TFT_eSPI &tft,
+// A tile narrower or shorter than the badge square leaves the rest blank.
+void pushTile(int16_t x, int16_t y, int16_t size, const uint16_t *pixels, int16_t w, int16_t h) {
+  if (w < size || h < size) g_tft->fillRect(x, y, size, size, Palette::BG);
+  g_tft->pushImage(x, y, w, h, pixels);
+}
+
+// Never downloads: a flag not yet in SPIFFS is queued for the prefetch task
+// and drawn as the fallback badge. Returns true if the real flag was drawn.
+bool drawLogoImpl(TFT_eSPI &tft,
                   const String &abbr,
                   const String &logoUrl,
                   int16_t x,
                   int16_t y,
                   int16_t size) {
   if (!g_tft) g_tft = &tft;
-  g_tft->fillRect(x, y, size, size, Palette::BG);
 
-  if (!abbr.isEmpty()) {
-    ensureFlagCached(abbr, logoUrl, size);
+  // Pre-rasterized in flash first, then already decoded in RAM.
+  FlagAtlas::Tile atlasTile;
+  if (!abbr.isEmpty() && FlagAtlas::find(abbr.c_str(), size, atlasTile)) {
+    pushTile(x, y, size, atlasTile.pixels, atlasTile.w, atlasTile.h);
+    return true;
+  }
+  FlagTileCache::Tile tile;
+  if (!abbr.isEmpty() && g_flagTiles.find(abbr.c_str(), size, tile)) {
+    pushTile(x, y, size, tile.pixels, tile.w, tile.h);
+    return true;
   }
 
+  g_tft->fillRect(x, y, size, size, Palette::BG);
+
   const String flagSized = makeFlagSizePath(size, abbr);
   const String flagFlat = makeFlagFlatPath(abbr);
 
   bool ok = false;
-  if (g_spiffsReady) {
-    if (!ok && SPIFFS.exists(flagSized)) ok = drawPngFromFs(SPIFFS, flagSized, x, y, size);
+  if (g_spiffsReady && !abbr.isEmpty()) {
+    if (!ok && flagExists(abbr, size)) ok = drawPngFromFs(SPIFFS, flagSized, x, y, size, abbr.c_str());
     if (!ok) {
       for (int16_t cachedSize : kFlagCacheSizes) {
         if (cachedSize == size) continue;
         const String candidate = makeFlagSizePath(cachedSize, abbr);
-        if (!SPIFFS.exists(candidate)) continue;
-        if (drawPngFromFs(SPIFFS, candidate, x, y, size)) {
+        if (!flagExists(abbr, cachedSize)) continue;
+        if (drawPngFromFs(SPIFFS, candidate, x, y, size, abbr.c_str())) {
           ok = true;
           break;
         }
       }
     }
-    if (!ok && SPIFFS.exists(flagFlat)) ok = drawPngFromFs(SPIFFS, flagFlat, x, y, size);
+    if (!ok && flagExists(abbr, 0)) ok = drawPngFromFs(SPIFFS, flagFlat, x, y, size, abbr.c_str());
   }
 
-
   if (!ok) {
+    queuePrefetch(abbr, logoUrl, size);
     drawFallbackBadge(x, y, size, abbr.c_str());
   }
+  return ok;
 }
 
 } // namespace
@@ -393,6 +639,7 @@ namespace Assets {
 
 void begin(TFT_eSPI &tft) {
   g_tft = &tft;
+  if (!g_lock) g_lock = xSemaphoreCreateMutex();
   g_tft->setSwapBytes(false);
 
   g_spiffsReady = SPIFFS.begin(true);
@@ -420,11 +667,21 @@ void begin(TFT_eSPI &tft) {
   g_sdReady = false;
 #endif
 
+  FlagAtlas::begin();
+
   if (g_spiffsReady) {
     ensureSpiffsDir("/flags");
     ensureSpiffsDir("/flags/56");
     ensureSpiffsDir("/flags/64");
     ensureSpiffsDir("/flags/96");
+    const bool complete = g_manifest.build();
+    Serial.printf("ASSETS: manifest %u flag files%s\n",
+                  (unsigned)g_manifest.count(),
+                  complete ? "" : " (incomplete, using SPIFFS lookups)");
+    // Core 0 below the network task, so feed polls always come first.
+    if (!g_prefetchTask) {
+      xTaskCreatePinnedToCore(prefetchTask, "flags", kPrefetchTaskStack, nullptr, 0, &g_prefetchTask, 0);
+    }
   }
 }
 
@@ -444,23 +701,35 @@ bool drawPng(TFT_eSPI &tft, const String &path, int16_t x, int16_t y) {
   return false;
 }
 
-void drawLogo(TFT_eSPI &tft, const String &abbr, int16_t x, int16_t y, int16_t size) {
-  drawLogoImpl(tft, abbr, String(""), x, y, size);
+bool drawLogo(TFT_eSPI &tft, const String &abbr, int16_t x, int16_t y, int16_t size) {
+  return drawLogoImpl(tft, abbr, String(""), x, y, size);
 }
 
-void drawLogo(TFT_eSPI &tft,
+bool drawLogo(TFT_eSPI &tft,
               const String &abbr,
               const String &logoUrl,
               int16_t x,
               int16_t y,
               int16_t size) {
-  drawLogoImpl(tft, abbr, logoUrl, x, y, size);
+  return drawLogoImpl(tft, abbr, logoUrl, x, y, size);
 }
 
 bool sdReady() {
   return g_sdReady;
 }
 
+FlagTileCache::Stats flagCacheStats() {
+  return g_flagTiles.stats();
+}
+
+void prefetchFlag(const String &abbr, const String &logoUrl, int16_t size) {
+  queuePrefetch(abbr, logoUrl, size);
+}
+
+uint32_t flagGeneration() {
+  return g_flagGeneration.load();
+}
+
 } // namespace Assets
 
 
@@ -3,6 +3,8 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 
+#include "flag_tile_cache.h"
+
 // Optional SD-logo support is configured via include/config.h.
 // This header stays lightweight; implementation lives in assets.cpp.
 
@@ -14,18 +16,30 @@ void begin(TFT_eSPI &tft);
 // Draw an image from SPIFFS/SD at x,y (top-left). Returns true on success.
 bool drawPng(TFT_eSPI &tft, const String &path, int16_t x, int16_t y);
 
-// Draw a team/country badge at x,y (top-left). Flag cache is preferred in SPIFFS.
-void drawLogo(TFT_eSPI &tft, const String &abbr, int16_t x, int16_t y, int16_t size = 56);
+// Draw a team/country badge at x,y (top-left). Flag cache is preferred in SPIFFS;
+// once decoded, a flag is redrawn from the in-RAM tile cache. Returns false if
+// the fallback badge was drawn instead.
+bool drawLogo(TFT_eSPI &tft, const String &abbr, int16_t x, int16_t y, int16_t size = 56);
 
-// Draw with optional remote logo URL for first-use SPIFFS caching.
-void drawLogo(TFT_eSPI &tft,
+// Draw with optional remote logo URL. A flag not cached yet is drawn as the
+// fallback badge and queued for the background prefetcher.
+bool drawLogo(TFT_eSPI &tft,
               const String &abbr,
               const String &logoUrl,
               int16_t x,
               int16_t y,
               int16_t size = 56);
 
+// Queue a flag for the background prefetcher ahead of its first draw. No-op
+// if SPIFFS already holds it or it is queued. Safe from any task.
+void prefetchFlag(const String &abbr, const String &logoUrl, int16_t size);
+
+// Bumped each time the prefetcher stores a flag; a change means some fallback
+// badge on screen can now be drawn as the real flag.
+uint32_t flagGeneration();
+
 // For diagnostics.
 bool sdReady();
+FlagTileCache::Stats flagCacheStats();
 
 } // namespace Assets
@@ -0,0 +1,172 @@
+#include "chunked_stream.h"
+
+namespace {
+
+// Chunk-size lines carry optional ";name=value" extensions; anything longer
+// than this is treated as a malformed body rather than buffered.
+static const size_t kMaxChunkLineLen = 128;
+static const size_t kMaxTrailerBytes = 1024;
+static const uint32_t kMaxChunkSize = 0x00FFFFFF;
+
+static int hexDigit(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+}  // namespace
+
+int ChunkedStream::available() {
+  if (_bufPos < _bufLen) return (int)(_bufLen - _bufPos);
+  if (_done || _failed || _remaining == 0) return 0;
+  const int avail = _src.available();
+  return (avail > (int)_remaining) ? (int)_remaining : avail;
+}
+
+int ChunkedStream::read() {
+  if (!fill()) return -1;
+  return _buf[_bufPos++];
+}
+
+int ChunkedStream::peek() {
+  if (!fill()) return -1;
+  return _buf[_bufPos];
+}
+
+size_t ChunkedStream::readBytes(char *buffer, size_t length) {
+  // Both JSON readers pull one byte at a time through here.
+  if (length == 1 && _bufPos < _bufLen) {
+    *buffer = (char)_buf[_bufPos++];
+    return 1;
+  }
+  uint8_t *dst = (uint8_t *)buffer;
+  size_t n = 0;
+  while (n < length) {
+    if (_bufPos < _bufLen) {
+      size_t take = _bufLen - _bufPos;
+      if (take > length - n) take = length - n;
+      memcpy(dst + n, _buf + _bufPos, take);
+      _bufPos += take;
+      n += take;
+      continue;
+    }
+    // Large requests skip the buffer and read the chunk straight into place.
+    if (length - n >= kBufferSize) {
+      const size_t got = readPayload(dst + n, length - n);
+      if (got == 0) break;
+      n += got;
+      continue;
+    }
+    if (!fill()) break;
+  }
+  return n;
+}
+
+bool ChunkedStream::drain(size_t maxBytes) {
+  _skipped += _bufLen - _bufPos;
+  _bufPos = _bufLen = 0;
+  while (!_done && !_failed) {
+    if (_skipped > maxBytes) return false;
+    const size_t n = readPayload(_buf, sizeof(_buf));
+    if (n == 0) break;
+    _skipped += n;
+  }
+  return _done && !_failed;
+}
+
+bool ChunkedStream::fill() {
+  if (_bufPos < _bufLen) return true;
+  _bufPos = 0;
+  _bufLen = readPayload(_buf, sizeof(_buf));
+  return _bufLen > 0;
+}
+
+// Reads up to `length` payload bytes from the current chunk, crossing into
+// the next chunk header when needed. Returns 0 at the end of the body or on
+// a framing error.
+size_t ChunkedStream::readPayload(uint8_t *dst, size_t length) {
+  if (_done || _failed) return 0;
+  if (_remaining == 0 && !readChunkHeader()) return 0;
+
+  const size_t want = (length < _remaining) ? length : _remaining;
+  // readBytes() honours the stream timeout, unlike read(), which returns -1 as
+  // soon as the socket buffer runs dry.
+  const size_t got = _src.readBytes((char *)dst, want);
+  _remaining -= (uint32_t)got;
+  if (got < want) {
+    _failed = true;
+  } else if (_remaining == 0 && !expectCrlf()) {
+    _failed = true;
+  }
+  return got;
+}
+
+bool ChunkedStream::readSrcByte(uint8_t &c) {
+  return _src.readBytes((char *)&c, 1) == 1;
+}
+
+bool ChunkedStream::readChunkHeader() {
+  uint32_t size = 0;
+  size_t digits = 0;
+  size_t lineLen = 0;
+  bool inExtension = false;
+  uint8_t c;
+  for (;;) {
+    if (!readSrcByte(c) || ++lineLen > kMaxChunkLineLen) {
+      _failed = true;
+      return false;
+    }
+    if (c == '\n') break;
+    if (c == '\r' || inExtension) continue;
+    if (c == ';' || c == ' ' || c == '\t') {
+      inExtension = true;
+      continue;
+    }
+    const int d = hexDigit(c);
+    if (d < 0 || size > (kMaxChunkSize >> 4)) {
+      _failed = true;
+      return false;
+    }
+    size = (size << 4) | (uint32_t)d;
+    digits++;
+  }
+  if (digits == 0) {
+    _failed = true;
+    return false;
+  }
+
+  if (size == 0) {
+    if (readTrailers()) {
+      _done = true;
+    } else {
+      _failed = true;
+    }
+    return false;
+  }
+  _remaining = size;
+  return true;
+}
+
+// After the last chunk come zero or more trailer header lines and a blank
+// line; none of them are of interest, but all must be consumed.
+bool ChunkedStream::readTrailers() {
+  size_t total = 0;
+  size_t lineLen = 0;
+  uint8_t c;
+  for (;;) {
+    if (!readSrcByte(c) || ++total > kMaxTrailerBytes) return false;
+    if (c == '\n') {
+      if (lineLen == 0) return true;
+      lineLen = 0;
+    } else if (c != '\r') {
+      lineLen++;
+    }
+  }
+}
+
+bool ChunkedStream::expectCrlf() {
+  uint8_t cr;
+  uint8_t lf;
+  return readSrcByte(cr) && readSrcByte(lf) && cr == '\r' && lf == '\n';
+}
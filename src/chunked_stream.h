@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Decodes an HTTP/1.1 chunked body on top of the raw socket stream. Readers
+// see only payload bytes; read() returns -1 once the terminal chunk is hit.
+// Payload is pulled from the socket a span at a time into a small buffer, so
+// per-byte reads and readBytes() from a parser cost no socket call.
+class ChunkedStream : public Stream {
+public:
+  static const size_t kBufferSize = 256;
+
+  explicit ChunkedStream(Stream &src) : _src(src) {}
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length) override;
+
+  // Consume whatever the parser left behind (rest of the payload, terminal
+  // chunk, trailers) so the socket is positioned at the next response.
+  // Returns false if the body ended early or was malformed, or if more than
+  // `maxBytes` of payload were left; the connection is then not reusable.
+  bool drain(size_t maxBytes = SIZE_MAX);
+
+  // Payload bytes discarded by drain().
+  size_t bytesSkipped() const { return _skipped; }
+
+  void flush() override {}
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  Stream &_src;
+  uint8_t _buf[kBufferSize];
+  size_t _bufPos = 0;
+  size_t _bufLen = 0;
+  uint32_t _remaining = 0;  // payload bytes of the current chunk still in _src
+  size_t _skipped = 0;
+  bool _done = false;
+  bool _failed = false;
+
+  bool fill();
+  size_t readPayload(uint8_t *dst, size_t length);
+  bool readSrcByte(uint8_t &c);
+  bool readChunkHeader();
+  bool readTrailers();
+  bool expectCrlf();
+};
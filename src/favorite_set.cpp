@@ -0,0 +1,72 @@
+#include "favorite_set.h"
+
+namespace {
+
+// Multipliers tried in turn by the perfect hash; odd, so every one is a
+// bijection on 32-bit words.
+static const uint32_t kFirstMultiplier = 2654435761u;
+static const uint32_t kMultiplierStep = 0x9E3779B8u;
+static const uint16_t kMaxMultiplierTries = 1000;
+
+static bool isSeparator(char c) {
+  return c == ',' || c == ' ' || c == ';' || c == '\t';
+}
+
+}  // namespace
+
+uint32_t packNoc(const char *code) {
+  uint32_t key = 0;
+  for (uint8_t i = 0; i < 3 && code[i]; ++i) {
+    key |= (uint32_t)(uint8_t)toupper((unsigned char)code[i]) << (8 * i);
+  }
+  return key;
+}
+
+bool FavoriteSet::place(uint32_t multiplier) {
+  memset(_slots, -1, sizeof(_slots));
+  for (uint8_t i = 0; i < _count; ++i) {
+    const uint8_t slot = (uint8_t)((_packed[i] * multiplier) >> (32 - kSlotBits));
+    if (_slots[slot] >= 0) return false;
+    _slots[slot] = (int8_t)i;
+  }
+  _multiplier = multiplier;
+  return true;
+}
+
+bool FavoriteSet::parse(const char *list) {
+  _count = 0;
+  const char *p = list ? list : "";
+  while (*p) {
+    while (isSeparator(*p)) p++;
+    const char *start = p;
+    while (*p && !isSeparator(*p)) p++;
+    if (p == start) continue;
+
+    char code[4] = {};
+    for (uint8_t i = 0; i < 3 && start + i < p; ++i) {
+      code[i] = (char)toupper((unsigned char)start[i]);
+    }
+    const uint32_t packed = packNoc(code);
+    bool seen = false;
+    for (uint8_t i = 0; i < _count; ++i) seen = seen || _packed[i] == packed;
+    if (seen) continue;
+    if (_count == kMaxFavorites) {
+      Serial.printf("FAV: only %u favourites supported, ignoring %s\n", (unsigned)kMaxFavorites, code);
+      continue;
+    }
+    _packed[_count] = packed;
+    memcpy(_codes[_count], code, sizeof(code));
+    _count++;
+  }
+
+  uint32_t multiplier = kFirstMultiplier;
+  for (uint16_t tries = 0; tries < kMaxMultiplierTries; ++tries, multiplier += kMultiplierStep) {
+    if (place(multiplier | 1u)) return _count > 0;
+  }
+  // Five keys in sixteen slots practically never get here; fall back to the
+  // first favourite alone rather than a set with false negatives.
+  Serial.println("FAV: no collision-free hash found, keeping the first favourite");
+  _count = min<uint8_t>(_count, 1);
+  place(kFirstMultiplier);
+  return _count > 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Most countries one board follows (FOCUS_TEAM_ABBRS).
+static const uint8_t kMaxFavorites = 5;
+
+// "can" -> 'C' | 'A' << 8 | 'N' << 16, so NOC codes compare and hash as one
+// word with no String work.
+uint32_t packNoc(const char *code);
+
+// The followed countries, in configured order; that order is also the index
+// used by the per-favourite arrays elsewhere. Membership is a perfect hash
+// over the packed codes: parse() picks a multiplier that gives every member
+// its own slot, so a lookup is one multiply, one load and one compare.
+class FavoriteSet {
+public:
+  // Parses a list such as "CAN,NOR USA". Codes are separated by commas or
+  // blanks; duplicates and codes past kMaxFavorites are ignored. Returns
+  // false if the list held no code.
+  bool parse(const char *list);
+
+  // Position of the country in the set, or -1.
+  int8_t indexOf(uint32_t packed) const {
+    const int8_t i = _slots[(packed * _multiplier) >> (32 - kSlotBits)];
+    return (i >= 0 && _packed[i] == packed) ? i : -1;
+  }
+  int8_t indexOf(const char *code) const { return indexOf(packNoc(code)); }
+
+  uint8_t count() const { return _count; }
+  const char *code(uint8_t i) const { return _codes[i]; }
+  uint32_t packed(uint8_t i) const { return _packed[i]; }
+
+private:
+  static const uint8_t kSlotBits = 4;
+
+  bool place(uint32_t multiplier);
+
+  uint32_t _packed[kMaxFavorites] = {};
+  char _codes[kMaxFavorites][4] = {};
+  uint32_t _multiplier = 0;
+  int8_t _slots[1 << kSlotBits] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+  uint8_t _count = 0;
+};
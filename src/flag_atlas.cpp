@@ -0,0 +1,87 @@
+#include "flag_atlas.h"
+
+#include <esp_partition.h>
+#include <esp_spi_flash.h>
+
+namespace {
+
+static const char *kPartitionLabel = "flags";
+
+const uint8_t *g_base = nullptr;
+const FlagAtlas::Entry *g_entries = nullptr;
+uint16_t g_count = 0;
+uint32_t g_totalBytes = 0;
+spi_flash_mmap_handle_t g_mapHandle = 0;
+
+// Orders like the tool's sort: code bytes, then size.
+static int compareEntry(const FlagAtlas::Entry &e, const char *code, uint16_t size) {
+  const int byCode = memcmp(e.code, code, sizeof(e.code));
+  if (byCode) return byCode;
+  return (int)e.size - (int)size;
+}
+
+}  // namespace
+
+namespace FlagAtlas {
+
+bool begin() {
+  if (g_base) return true;
+  const esp_partition_t *part =
+      esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, kPartitionLabel);
+  if (!part) {
+    Serial.println("FLAGS: no atlas partition");
+    return false;
+  }
+
+  Header header;
+  if (esp_partition_read(part, 0, &header, sizeof(header)) != ESP_OK || header.magic != kMagic ||
+      header.version != kVersion || header.totalBytes > part->size ||
+      sizeof(Header) + (uint32_t)header.count * sizeof(Entry) > header.totalBytes) {
+    Serial.println("FLAGS: atlas partition empty or invalid");
+    return false;
+  }
+
+  const void *mapped = nullptr;
+  if (esp_partition_mmap(part, 0, header.totalBytes, SPI_FLASH_MMAP_DATA, &mapped, &g_mapHandle) != ESP_OK) {
+    Serial.println("FLAGS: atlas mmap failed");
+    return false;
+  }
+  g_base = (const uint8_t *)mapped;
+  g_entries = (const Entry *)(g_base + sizeof(Header));
+  g_count = header.count;
+  g_totalBytes = header.totalBytes;
+  Serial.printf("FLAGS: atlas %u tiles, %lu bytes\n", (unsigned)g_count, (unsigned long)header.totalBytes);
+  return true;
+}
+
+bool ready() {
+  return g_base != nullptr;
+}
+
+bool find(const char *code, int16_t size, Tile &out) {
+  if (!g_base || !code || size <= 0) return false;
+  char key[4] = {};
+  for (uint8_t i = 0; i < sizeof(key) && code[i]; ++i) key[i] = (char)toupper((unsigned char)code[i]);
+
+  int lo = 0;
+  int hi = (int)g_count - 1;
+  while (lo <= hi) {
+    const int mid = (lo + hi) / 2;
+    const int cmp = compareEntry(g_entries[mid], key, (uint16_t)size);
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else if (cmp > 0) {
+      hi = mid - 1;
+    } else {
+      const Entry &e = g_entries[mid];
+      if (e.offset + (uint32_t)e.w * e.h * sizeof(uint16_t) > g_totalBytes || (e.offset & 1)) return false;
+      out.pixels = (const uint16_t *)(g_base + e.offset);
+      out.w = (int16_t)e.w;
+      out.h = (int16_t)e.h;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace FlagAtlas
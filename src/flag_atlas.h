@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Flags pre-rasterized by tools/fetch_flags.py --atlas into the `flags`
+// partition, at the sizes the UI draws (12px table rows, 72px alert). The
+// partition is memory-mapped once, so a tile is read in place: no decode,
+// no filesystem lookup.
+//
+// Layout, little-endian: a Header, `count` Entries sorted by (code, size),
+// then RGB565 pixels stored big-endian as pushImage expects them.
+namespace FlagAtlas {
+
+static const uint32_t kMagic = 0x47414C46;  // "FLAG"
+static const uint16_t kVersion = 1;
+
+struct Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+  uint32_t totalBytes;
+};
+
+struct Entry {
+  char code[4];  // upper case, NUL padded
+  uint16_t size;
+  uint16_t w;
+  uint16_t h;
+  uint16_t reserved;
+  uint32_t offset;  // from the start of the atlas
+};
+
+static_assert(sizeof(Header) == 12, "atlas header layout");
+static_assert(sizeof(Entry) == 16, "atlas entry layout");
+
+struct Tile {
+  const uint16_t *pixels = nullptr;
+  int16_t w = 0;
+  int16_t h = 0;
+};
+
+// Maps the partition if it holds a valid atlas. Without one every find()
+// misses and flags come from SPIFFS as before.
+bool begin();
+bool ready();
+
+bool find(const char *code, int16_t size, Tile &out);
+
+}  // namespace FlagAtlas
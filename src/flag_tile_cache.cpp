@@ -0,0 +1,91 @@
+#include "flag_tile_cache.h"
+
+#include "favorite_set.h"
+
+namespace {
+
+// Flag sizes are small, so the size shares the word with the 24-bit code.
+static uint32_t tileKey(const char *code, int16_t size) {
+  return packNoc(code) | (uint32_t)(uint8_t)size << 24;
+}
+
+}  // namespace
+
+int FlagTileCache::indexOf(uint32_t key) const {
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_entries[i].key == key) return i;
+  }
+  return -1;
+}
+
+void FlagTileCache::evict(uint8_t index) {
+  const Entry gone = _entries[index];
+  const uint32_t tail = _used - (gone.offset + gone.pixels);
+  memmove(&_arena[gone.offset], &_arena[gone.offset + gone.pixels], tail * sizeof(uint16_t));
+  for (uint8_t i = index + 1; i < _count; ++i) {
+    _entries[i - 1] = _entries[i];
+    _entries[i - 1].offset -= gone.pixels;
+  }
+  _count--;
+  _used -= gone.pixels;
+}
+
+bool FlagTileCache::find(const char *code, int16_t size, Tile &out) {
+  const int i = indexOf(tileKey(code, size));
+  if (i < 0) {
+    _misses++;
+    return false;
+  }
+  Entry &e = _entries[i];
+  e.lastUse = ++_clock;
+  out.pixels = &_arena[e.offset];
+  out.w = e.w;
+  out.h = e.h;
+  _hits++;
+  return true;
+}
+
+uint16_t *FlagTileCache::reserve(const char *code, int16_t size, int16_t w, int16_t h) {
+  if (w <= 0 || h <= 0 || size <= 0 || size > 255) return nullptr;
+  const uint32_t pixels = (uint32_t)w * (uint32_t)h;
+  if (pixels > kArenaPixels) return nullptr;
+
+  const uint32_t key = tileKey(code, size);
+  const int existing = indexOf(key);
+  if (existing >= 0) evict((uint8_t)existing);
+
+  while (_count == kMaxTiles || _used + pixels > kArenaPixels) {
+    uint8_t oldest = 0;
+    for (uint8_t i = 1; i < _count; ++i) {
+      if (_entries[i].lastUse < _entries[oldest].lastUse) oldest = i;
+    }
+    evict(oldest);
+    _evictions++;
+  }
+
+  Entry &e = _entries[_count++];
+  e.key = key;
+  e.offset = _used;
+  e.pixels = pixels;
+  e.lastUse = ++_clock;
+  e.w = w;
+  e.h = h;
+  _used += pixels;
+  return &_arena[e.offset];
+}
+
+void FlagTileCache::drop(const char *code, int16_t size) {
+  const int i = indexOf(tileKey(code, size));
+  if (i >= 0) evict((uint8_t)i);
+}
+
+FlagTileCache::Stats FlagTileCache::stats() const {
+  Stats s;
+  s.hits = _hits;
+  s.misses = _misses;
+  s.evictions = _evictions;
+  s.bytesUsed = _used * sizeof(uint16_t);
+  s.budget = kArenaPixels * sizeof(uint16_t);
+  s.tiles = _count;
+  return s;
+}
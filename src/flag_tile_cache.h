@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+
+// RAM kept for decoded flags; a 72px alert flag is about 7 KB, a medal-table
+// flag a few hundred bytes.
+#ifndef FLAG_TILE_CACHE_BYTES
+#define FLAG_TILE_CACHE_BYTES (24 * 1024)
+#endif
+
+// Flags already decoded and scaled to RGB565, keyed by (code, size), so a
+// repeat draw is one pushImage with no filesystem or PNG work. Tiles live
+// back to back in one fixed arena; making room evicts the least recently
+// drawn tiles and slides the rest down.
+class FlagTileCache {
+public:
+  static const uint8_t kMaxTiles = 32;
+
+  struct Tile {
+    const uint16_t *pixels = nullptr;
+    int16_t w = 0;
+    int16_t h = 0;
+  };
+
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+    uint32_t bytesUsed = 0;
+    uint32_t budget = 0;
+    uint8_t tiles = 0;
+  };
+
+  // Looks the tile up and marks it recently used; counts a hit or a miss.
+  // The pixels stay valid until the next reserve().
+  bool find(const char *code, int16_t size, Tile &out);
+
+  // Makes room for a w x h tile and returns its pixels for the caller to
+  // fill, or nullptr if it can never fit. A failed fill must be dropped.
+  uint16_t *reserve(const char *code, int16_t size, int16_t w, int16_t h);
+  void drop(const char *code, int16_t size);
+
+  Stats stats() const;
+
+private:
+  static const uint32_t kArenaPixels = FLAG_TILE_CACHE_BYTES / sizeof(uint16_t);
+
+  struct Entry {
+    uint32_t key;
+    uint32_t offset;  // in pixels, entries are kept in arena order
+    uint32_t pixels;
+    uint32_t lastUse;
+    int16_t w;
+    int16_t h;
+  };
+
+  int indexOf(uint32_t key) const;
+  void evict(uint8_t index);
+
+  uint16_t _arena[kArenaPixels];
+  Entry _entries[kMaxTiles];
+  uint8_t _count = 0;
+  uint32_t _used = 0;
+  uint32_t _clock = 0;
+  uint32_t _hits = 0;
+  uint32_t _misses = 0;
+  uint32_t _evictions = 0;
+};
@@ -0,0 +1,215 @@
+#include "inflate_stream.h"
+
+#include <rom/crc.h>
+
+namespace {
+
+static const uint8_t kGzipId1 = 0x1F;
+static const uint8_t kGzipId2 = 0x8B;
+static const uint8_t kGzipMethodDeflate = 8;
+static const uint8_t kGzipFlagHcrc = 0x02;
+static const uint8_t kGzipFlagExtra = 0x04;
+static const uint8_t kGzipFlagName = 0x08;
+static const uint8_t kGzipFlagComment = 0x10;
+
+}  // namespace
+
+InflateStream::~InflateStream() {
+  free(_mem);
+}
+
+bool InflateStream::reserve() {
+  if (_mem) return true;
+  _mem = (uint8_t *)malloc(kHeapBytes);
+  if (!_mem) return false;
+  // The window must be a power-of-two ring for tinfl, so it goes first.
+  _window = _mem;
+  _decomp = (tinfl_decompressor *)(_mem + kWindowSize);
+  _input = _mem + kWindowSize + sizeof(tinfl_decompressor);
+  return true;
+}
+
+void InflateStream::release() {
+  free(_mem);
+  _mem = nullptr;
+  _window = _input = nullptr;
+  _decomp = nullptr;
+  _failed = true;
+}
+
+void InflateStream::begin(Stream &src, Format format, size_t limit) {
+  _src = &src;
+  _format = format;
+  _limit = limit;
+  _sourceBytes = 0;
+  _inPos = _inLen = 0;
+  _writePos = _readPos = _pending = 0;
+  _crc = 0;
+  _outTotal = 0;
+  _started = false;
+  _done = false;
+  _failed = !_mem;
+  if (_mem) tinfl_init(_decomp);
+}
+
+int InflateStream::available() {
+  return fill() ? (int)_pending : 0;
+}
+
+int InflateStream::read() {
+  if (!fill()) return -1;
+  const uint8_t c = _window[_readPos++];
+  _pending--;
+  return c;
+}
+
+int InflateStream::peek() {
+  if (!fill()) return -1;
+  return _window[_readPos];
+}
+
+size_t InflateStream::readBytes(char *buffer, size_t length) {
+  size_t n = 0;
+  while (n < length && fill()) {
+    size_t take = _pending;
+    if (take > length - n) take = length - n;
+    memcpy(buffer + n, _window + _readPos, take);
+    _readPos += take;
+    _pending -= take;
+    n += take;
+  }
+  return n;
+}
+
+bool InflateStream::finish() {
+  while (fill()) {
+    _readPos += _pending;
+    _pending = 0;
+  }
+  return _done && !_failed;
+}
+
+// Makes output available at _readPos, inflating more input as needed.
+// Returns false at the end of the stream or on corrupt input.
+bool InflateStream::fill() {
+  if (_pending) return true;
+  if (!_src || _done || _failed) return false;
+  if (!_started) {
+    _started = true;
+    if (_format == Format::GZIP && !readGzipHeader()) {
+      _failed = true;
+      return false;
+    }
+  }
+
+  while (!_pending) {
+    if (_inPos == _inLen && !refillInput()) {
+      _failed = true;
+      return false;
+    }
+    size_t inBytes = _inLen - _inPos;
+    size_t outBytes = kWindowSize - _writePos;
+    uint32_t flags = TINFL_FLAG_HAS_MORE_INPUT;
+    if (_format == Format::ZLIB) flags |= TINFL_FLAG_PARSE_ZLIB_HEADER;
+    const tinfl_status status =
+      tinfl_decompress(_decomp, _input + _inPos, &inBytes, _window, _window + _writePos, &outBytes, flags);
+    _inPos += inBytes;
+    if (outBytes) {
+      _crc = crc32_le(_crc, _window + _writePos, (uint32_t)outBytes);
+      _outTotal += (uint32_t)outBytes;
+      _readPos = _writePos;
+      _pending = outBytes;
+      _writePos = (_writePos + outBytes) & (kWindowSize - 1);
+    }
+    if (status == TINFL_STATUS_DONE) {
+      _done = true;
+      if (_format == Format::GZIP && !readGzipTrailer()) _failed = true;
+      break;
+    }
+    if (status < 0) {
+      Serial.printf("INFLATE: corrupt stream (%d) after %u B\n", (int)status, (unsigned)_sourceBytes);
+      _failed = true;
+      break;
+    }
+  }
+  return _pending > 0;
+}
+
+bool InflateStream::refillInput() {
+  if (_sourceBytes >= _limit) return false;
+  size_t want = kInputSize;
+  if (want > _limit - _sourceBytes) want = _limit - _sourceBytes;
+  const size_t got = _src->readBytes((char *)_input, want);
+  _sourceBytes += got;
+  _inPos = 0;
+  _inLen = got;
+  return got > 0;
+}
+
+bool InflateStream::nextInputByte(uint8_t &c) {
+  if (_inPos == _inLen && !refillInput()) return false;
+  c = _input[_inPos++];
+  return true;
+}
+
+bool InflateStream::skipInput(size_t n) {
+  uint8_t c;
+  while (n--) {
+    if (!nextInputByte(c)) return false;
+  }
+  return true;
+}
+
+// RFC 1952 member header: magic, method, flags, mtime, xfl, os, then the
+// optional extra field, file name, comment and header CRC.
+bool InflateStream::readGzipHeader() {
+  uint8_t header[10];
+  for (uint8_t &b : header) {
+    if (!nextInputByte(b)) return false;
+  }
+  if (header[0] != kGzipId1 || header[1] != kGzipId2 || header[2] != kGzipMethodDeflate) {
+    Serial.println("INFLATE: not a gzip stream");
+    return false;
+  }
+  const uint8_t flags = header[3];
+  if (flags & kGzipFlagExtra) {
+    uint8_t lo;
+    uint8_t hi;
+    if (!nextInputByte(lo) || !nextInputByte(hi) || !skipInput((size_t)lo | ((size_t)hi << 8))) return false;
+  }
+  for (const uint8_t flag : {kGzipFlagName, kGzipFlagComment}) {
+    if (!(flags & flag)) continue;
+    uint8_t c;
+    do {
+      if (!nextInputByte(c)) return false;
+    } while (c != 0);
+  }
+  return !(flags & kGzipFlagHcrc) || skipInput(2);
+}
+
+// The CRC-32 and length follow the deflate data. tinfl may already have
+// pulled some of those bytes into its bit buffer, so they are taken from there
+// first (whole bytes above the final block's padding bits).
+bool InflateStream::readGzipTrailer() {
+  uint8_t trailer[8];
+  uint64_t bits = (uint64_t)_decomp->m_bit_buf >> (_decomp->m_num_bits & 7);
+  size_t buffered = _decomp->m_num_bits >> 3;
+  for (uint8_t &b : trailer) {
+    if (buffered) {
+      b = (uint8_t)bits;
+      bits >>= 8;
+      buffered--;
+    } else if (!nextInputByte(b)) {
+      return false;
+    }
+  }
+  const uint32_t crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) | ((uint32_t)trailer[2] << 16) |
+                       ((uint32_t)trailer[3] << 24);
+  const uint32_t size = (uint32_t)trailer[4] | ((uint32_t)trailer[5] << 8) | ((uint32_t)trailer[6] << 16) |
+                        ((uint32_t)trailer[7] << 24);
+  if (crc != _crc || size != _outTotal) {
+    Serial.println("INFLATE: gzip CRC/length mismatch");
+    return false;
+  }
+  return true;
+}
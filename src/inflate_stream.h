@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+#include <rom/miniz.h>
+
+// Streams a gzip or zlib ("deflate") body through the ROM inflater. Output is
+// read straight out of the 32 KB deflate window, so the only RAM is one heap
+// block (decompressor + window + input buffer) held for the request.
+class InflateStream : public Stream {
+public:
+  enum class Format : uint8_t {
+    GZIP,
+    ZLIB
+  };
+
+  static const size_t kWindowSize = TINFL_LZ_DICT_SIZE;
+  static const size_t kInputSize = 1024;
+  static const size_t kHeapBytes = sizeof(tinfl_decompressor) + kWindowSize + kInputSize;
+
+  InflateStream() {}
+  ~InflateStream();
+  InflateStream(const InflateStream &) = delete;
+  InflateStream &operator=(const InflateStream &) = delete;
+
+  // Allocates the working memory up front; false if the heap cannot spare it.
+  bool reserve();
+  bool reserved() const { return _mem != nullptr; }
+  // Frees the working memory early; sourceBytes() stays valid.
+  void release();
+
+  // Starts decoding from `src`, reading at most `limit` compressed bytes.
+  void begin(Stream &src, Format format, size_t limit = SIZE_MAX);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length) override;
+
+  // Inflates and discards the rest of the body and checks the gzip CRC and
+  // length (zlib's Adler-32 is checked by the inflater). True if intact.
+  bool finish();
+
+  // Compressed bytes pulled from the source so far.
+  size_t sourceBytes() const { return _sourceBytes; }
+
+  void flush() override {}
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  uint8_t *_mem = nullptr;
+  tinfl_decompressor *_decomp = nullptr;
+  uint8_t *_window = nullptr;
+  uint8_t *_input = nullptr;
+  Stream *_src = nullptr;
+  Format _format = Format::GZIP;
+  size_t _limit = 0;
+  size_t _sourceBytes = 0;
+  size_t _inPos = 0;
+  size_t _inLen = 0;
+  size_t _writePos = 0;  // where the inflater writes next in the window
+  size_t _readPos = 0;   // next unread output byte in the window
+  size_t _pending = 0;   // unread output bytes at _readPos
+  uint32_t _crc = 0;
+  uint32_t _outTotal = 0;
+  bool _started = false;
+  bool _done = false;
+  bool _failed = false;
+
+  bool fill();
+  bool refillInput();
+  bool nextInputByte(uint8_t &c);
+  bool skipInput(size_t n);
+  bool readGzipHeader();
+  bool readGzipTrailer();
+};
@@ -0,0 +1,206 @@
+#include "json_sax.h"
+
+namespace {
+
+static bool isJsonSpace(int c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static int hexValue(int c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Appends a code point as UTF-8, dropping it if it does not fit.
+static void appendUtf8(char *buf, size_t cap, size_t &len, uint32_t cp) {
+  char enc[4];
+  size_t n = 0;
+  if (cp < 0x80) {
+    enc[n++] = (char)cp;
+  } else if (cp < 0x800) {
+    enc[n++] = (char)(0xC0 | (cp >> 6));
+    enc[n++] = (char)(0x80 | (cp & 0x3F));
+  } else {
+    enc[n++] = (char)(0xE0 | (cp >> 12));
+    enc[n++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    enc[n++] = (char)(0x80 | (cp & 0x3F));
+  }
+  if (len + n >= cap) return;
+  memcpy(buf + len, enc, n);
+  len += n;
+}
+
+}  // namespace
+
+bool JsonSaxParser::keyIs(uint8_t level, const char *key) const {
+  if (level >= _depth || _frames[level].isArray) return false;
+  return strcmp(_frames[level].key, key) == 0;
+}
+
+int JsonSaxParser::nextByte() {
+  if (_pending >= 0) {
+    const int c = _pending;
+    _pending = -1;
+    return c;
+  }
+  // readBytes() waits up to the stream timeout, unlike read() which returns
+  // -1 as soon as the socket buffer runs dry.
+  char c;
+  if (_src.readBytes(&c, 1) != 1) return -1;
+  _bytesRead++;
+  return (uint8_t)c;
+}
+
+int JsonSaxParser::nextToken() {
+  int c;
+  do {
+    c = nextByte();
+  } while (isJsonSpace(c));
+  return c;
+}
+
+bool JsonSaxParser::checkDone() {
+  if (_handler.done()) _stopped = true;
+  return _stopped;
+}
+
+bool JsonSaxParser::parse() {
+  _depth = 0;
+  _pending = -1;
+  _stopped = false;
+  _bytesRead = 0;
+  const bool ok = parseValue(nextToken());
+  return ok || _stopped;
+}
+
+bool JsonSaxParser::parseValue(int c) {
+  switch (c) {
+    case '{': return parseContainer(false);
+    case '[': return parseContainer(true);
+    case '"':
+      if (!parseString(_text, sizeof(_text))) return false;
+      _handler.onValue(*this, JsonSaxType::STRING, _text);
+      return !checkDone();
+    case 't':
+    case 'f':
+    case 'n':
+      return parseLiteral(c);
+    default:
+      if (c == '-' || (c >= '0' && c <= '9')) return parseNumber(c);
+      return false;
+  }
+}
+
+bool JsonSaxParser::parseContainer(bool isArray) {
+  if (_depth >= kMaxDepth || !_handler.wantsContainer(*this, isArray)) return skipContainer();
+  Frame &frame = _frames[_depth++];
+  frame.isArray = isArray;
+  frame.index = 0;
+  frame.key[0] = '\0';
+  _handler.onContainerStart(*this);
+
+  const char close = isArray ? ']' : '}';
+  int c = nextToken();
+  if (c != close) {
+    for (;;) {
+      if (!isArray) {
+        if (c != '"' || !parseString(frame.key, sizeof(frame.key))) return false;
+        if (nextToken() != ':') return false;
+        c = nextToken();
+      }
+      if (!parseValue(c)) return false;
+
+      c = nextToken();
+      if (c == close) break;
+      if (c != ',') return false;
+      if (isArray) frame.index++;
+      c = nextToken();
+    }
+  }
+
+  _handler.onContainerEnd(*this);
+  _depth--;
+  return !checkDone();
+}
+
+// Consumes the rest of a container after its opening bracket. Only the
+// nesting is counted, so no frame is needed however deep it goes; strings are
+// read through so brackets inside them don't count.
+bool JsonSaxParser::skipContainer() {
+  uint32_t nested = 1;
+  while (nested) {
+    const int c = nextByte();
+    if (c < 0) return false;
+    if (c == '"') {
+      if (!parseString(_text, sizeof(_text))) return false;
+    } else if (c == '{' || c == '[') {
+      nested++;
+    } else if (c == '}' || c == ']') {
+      nested--;
+    }
+  }
+  return true;
+}
+
+bool JsonSaxParser::parseString(char *buf, size_t cap) {
+  size_t len = 0;
+  for (;;) {
+    int c = nextByte();
+    if (c < 0) return false;
+    if (c == '"') break;
+    if (c == '\\') {
+      c = nextByte();
+      switch (c) {
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': {
+          uint32_t cp = 0;
+          for (uint8_t i = 0; i < 4; ++i) {
+            const int h = hexValue(nextByte());
+            if (h < 0) return false;
+            cp = (cp << 4) | (uint32_t)h;
+          }
+          appendUtf8(buf, cap, len, cp);
+          continue;
+        }
+        case '"':
+        case '\\':
+        case '/':
+          break;
+        default:
+          return false;
+      }
+    }
+    if (len + 1 < cap) buf[len++] = (char)c;
+  }
+  buf[len] = '\0';
+  return true;
+}
+
+bool JsonSaxParser::parseNumber(int first) {
+  size_t len = 0;
+  int c = first;
+  while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) {
+    if (len + 1 < sizeof(_text)) _text[len++] = (char)c;
+    c = nextByte();
+  }
+  _text[len] = '\0';
+  _pending = c;
+  _handler.onValue(*this, JsonSaxType::NUMBER, _text);
+  return !checkDone();
+}
+
+bool JsonSaxParser::parseLiteral(int first) {
+  const char *word = (first == 't') ? "true" : (first == 'f') ? "false" : "null";
+  for (const char *p = word + 1; *p; ++p) {
+    if (nextByte() != *p) return false;
+  }
+  strcpy(_text, word);
+  _handler.onValue(*this, first == 'n' ? JsonSaxType::NUL : JsonSaxType::BOOL, _text);
+  return !checkDone();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Minimal event-driven JSON reader. It walks a Stream once, keeps only the
+// current key path and the current scalar in fixed buffers, and hands each
+// value to a handler; no document is ever built.
+
+enum class JsonSaxType : uint8_t {
+  STRING,
+  NUMBER,
+  BOOL,
+  NUL
+};
+
+class JsonSaxParser;
+
+class JsonSaxHandler {
+public:
+  virtual ~JsonSaxHandler() {}
+
+  // Asked before an object/array is entered, with depth() still that of its
+  // parent. A container the handler declines is skipped unseen, as is one
+  // deeper than kMaxDepth, so nesting the handler ignores never fails a parse.
+  virtual bool wantsContainer(const JsonSaxParser &parser, bool isArray) {
+    (void)parser;
+    (void)isArray;
+    return true;
+  }
+
+  // Fired after an object/array has been entered (depth() includes it) and
+  // before it is left.
+  virtual void onContainerStart(const JsonSaxParser &parser) { (void)parser; }
+  virtual void onContainerEnd(const JsonSaxParser &parser) { (void)parser; }
+
+  // Scalar value located by parser.keyIs()/index() at level depth() - 1.
+  virtual void onValue(const JsonSaxParser &parser, JsonSaxType type, const char *text) = 0;
+
+  // Return true once everything needed has been captured; parsing stops there.
+  virtual bool done() const { return false; }
+};
+
+class JsonSaxParser {
+public:
+  static const uint8_t kMaxDepth = 8;
+  static const uint8_t kMaxKeyLen = 23;
+  static const uint8_t kMaxTextLen = 95;
+
+  JsonSaxParser(Stream &src, JsonSaxHandler &handler) : _src(src), _handler(handler) {}
+
+  // Reads one top-level value. Returns true if it was well formed or the
+  // handler asked to stop early (see stoppedEarly()).
+  bool parse();
+
+  uint8_t depth() const { return _depth; }
+  bool isArray(uint8_t level) const { return level < _depth && _frames[level].isArray; }
+  uint16_t index(uint8_t level) const { return level < _depth ? _frames[level].index : 0; }
+  bool keyIs(uint8_t level, const char *key) const;
+
+  bool stoppedEarly() const { return _stopped; }
+  size_t bytesRead() const { return _bytesRead; }
+
+private:
+  struct Frame {
+    bool isArray;
+    uint16_t index;
+    char key[kMaxKeyLen + 1];
+  };
+
+  Stream &_src;
+  JsonSaxHandler &_handler;
+  Frame _frames[kMaxDepth];
+  uint8_t _depth = 0;
+  int _pending = -1;
+  bool _stopped = false;
+  size_t _bytesRead = 0;
+  char _text[kMaxTextLen + 1];
+
+  int nextByte();
+  int nextToken();
+  bool checkDone();
+  bool parseValue(int c);
+  bool parseContainer(bool isArray);
+  bool skipContainer();
+  bool parseString(char *buf, size_t cap);
+  bool parseNumber(int first);
+  bool parseLiteral(int first);
+};
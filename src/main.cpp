@@ -3,15 +3,28 @@
 #include <WiFi.h>
 #include <time.h>
 
+#include <atomic>
+
 #include "anthem.h"
 #include "assets.h"
 #include "config.h"
+#include "favorite_set.h"
 #include "olympic_scoreboard_client.h"
 #include "olympic_scoreboard_ui.h"
+#include "medal_diff.h"
+#include "poll_scheduler.h"
+#include "schedule_cache.h"
+#include "snapshot_buffer.h"
+#include "state_store.h"
 #include "wifi_fallback.h"
 
 SET_LOOP_TASK_STACK_SIZE(16 * 1024);
 
+// Configs from before multiple favourites name a single country.
+#if !defined(FOCUS_TEAM_ABBRS) && defined(FOCUS_TEAM_ABBR)
+#define FOCUS_TEAM_ABBRS FOCUS_TEAM_ABBR
+#endif
+
 namespace {
 
 enum class ScreenPage : uint8_t {
@@ -19,39 +32,85 @@ enum class ScreenPage : uint8_t {
   SCHEDULE
 };
 
+// Time spent drawing one kind of page since the last report.
+struct DrawStats {
+  uint32_t count;
+  uint32_t totalUs;
+  uint32_t maxUs;
+};
+
+// A cached day after today and when it was last fetched.
+struct FutureScheduleDay {
+  char dateYmd[sizeof(DailyScheduleState::dateYmd)];
+  uint32_t lastAttemptMs;
+  bool attempted;
+  bool ok;
+};
+
 static TFT_eSPI tft;
 static OlympicScoreboardUi ui;
 static OlympicScoreboardClient client;
+// Parsed in setup() before the network task starts; read-only afterwards.
+static FavoriteSet favorites;
 
-static ScreenPage currentPage = ScreenPage::MEDALS;
-static MedalTableState medals;
-static DailyScheduleState scheduleToday;
-static bool hasMedals = false;
-static bool hasSchedule = false;
+// --- Network task (core 0) state. Only networkTask() touches these. ---
+static MedalTableState netMedals;
+static DailyScheduleState netSchedule;
+static bool netHasMedals = false;
 static bool sportBaselinePrimed = false;
-
+static PollScheduler pollScheduler;
 static uint32_t lastMedalsPollMs = 0;
 static uint32_t lastSchedulePollMs = 0;
-static uint32_t lastRotateMs = 0;
-static uint32_t lastGoodMedalsMs = 0;
-static uint32_t lastGoodScheduleMs = 0;
-
+static uint32_t lastPollPlanMs = 0;
+static DailyScheduleState scheduleScratch;
+static FutureScheduleDay futureDays[ScheduleCache::kDaysAhead] = {};
+static char prunedForYmd[sizeof(DailyScheduleState::dateYmd)] = {};
+// Segments left by a previous boot count as changed, so the first pass looks.
+static uint32_t nextMedalGeneration = UINT32_MAX;
 static bool timeConfigured = false;
 static uint32_t lastTimeConfigAttemptMs = 0;
-static bool lastWifiConnected = false;
 
-static const uint32_t kMedalsPollIntervalMs = 30000;
-static const uint32_t kSchedulePollIntervalMs = 60000;
+// --- Handoff between the network task and the UI loop. ---
+static SnapshotBuffer<MedalTableState> publishedMedals;
+static SnapshotBuffer<DailyScheduleState> publishedSchedule;
+static std::atomic<uint32_t> lastGoodMedalsMs{0};
+static std::atomic<uint32_t> lastGoodScheduleMs{0};
+static std::atomic<uint32_t> medalsPollIntervalMs{PollScheduler::kDefaultMedalsIntervalMs};
+static std::atomic<uint32_t> schedulePollIntervalMs{PollScheduler::kDefaultScheduleIntervalMs};
+static QueueHandle_t alertQueue = nullptr;
+static MedalDiff::EventQueue medalEvents;
+static uint16_t droppedMedalEvents = 0;
+
+// --- UI loop (core 1) state. ---
+static ScreenPage currentPage = ScreenPage::MEDALS;
+static MedalTableState medals;
+static DailyScheduleState scheduleToday;
+static uint32_t medalsSeq = 0;
+static uint32_t scheduleSeq = 0;
+static uint32_t lastRotateMs = 0;
+static bool lastWifiConnected = false;
+static bool lastRenderedStale = true;
+static uint32_t seenFlagGeneration = 0;
+// Medals, schedule, alert.
+static DrawStats drawStats[3] = {};
+static uint32_t lastDrawReportMs = 0;
+static FlagTileCache::Stats lastFlagStats;
+
+static const uint32_t kPollPlanIntervalMs = 10000;
+static const uint32_t kFutureScheduleRefreshMs = 3UL * 3600UL * 1000UL;
+static const uint32_t kFutureScheduleRetryMs = 10UL * 60UL * 1000UL;
 static const uint32_t kRotateIntervalMs = 18000;
 static const uint32_t kStaleAfterMs = 90000;
 static const uint32_t kAlertPopupMs = 6000;
 static const uint32_t kAlertAudioMs = 8000;
+static const uint32_t kDrawReportIntervalMs = 5UL * 60UL * 1000UL;
 
-static const uint8_t kAlertQueueSize = 4;
-static MedalAlertEvent alertQueue[kAlertQueueSize];
-static uint8_t alertHead = 0;
-static uint8_t alertTail = 0;
-static uint8_t alertCount = 0;
+static const uint8_t kAlertQueueSize = 8;
+// Alerts one poll may raise: a medal of each colour, each possibly split
+// across sports.
+static const uint8_t kMaxAlertsPerPoll = 6;
+static const uint32_t kNetworkTaskStack = 16 * 1024;
+static const uint32_t kNetworkTaskIdleMs = 50;
 
 static bool alertActive = false;
 static MedalAlertEvent activeAlert;
@@ -77,53 +136,136 @@ static void ensureTimeConfigured(uint32_t nowMs) {
   }
 }
 
-static String todayYmd() {
+static bool clockValid() {
+  return time(nullptr) > 1577836800;
+}
+
+// Local date `dayOffset` days from today. Noon keeps mktime's normalisation
+// clear of DST changes at midnight.
+static String localYmd(int dayOffset) {
   time_t now = time(nullptr);
   if (now <= 1577836800) {
     return String("2026-02-11");
   }
   struct tm lt;
   localtime_r(&now, &lt);
+  if (dayOffset != 0) {
+    lt.tm_mday += dayOffset;
+    lt.tm_hour = 12;
+    lt.tm_isdst = -1;
+    const time_t then = mktime(&lt);
+    localtime_r(&then, &lt);
+  }
   char buf[16];
   strftime(buf, sizeof(buf), "%Y-%m-%d", &lt);
   return String(buf);
 }
 
+static String todayYmd() {
+  return localYmd(0);
+}
+
+// Called from the network task; drops the oldest alert when the queue is full.
 static bool enqueueAlert(const MedalAlertEvent &ev) {
-  if (!ev.valid) return false;
-  if (alertCount >= kAlertQueueSize) {
-    alertHead = (uint8_t)((alertHead + 1) % kAlertQueueSize);
-    alertCount--;
-  }
-  alertQueue[alertTail] = ev;
-  alertTail = (uint8_t)((alertTail + 1) % kAlertQueueSize);
-  alertCount++;
-  return true;
+  if (!ev.valid || !alertQueue) return false;
+  if (uxQueueSpacesAvailable(alertQueue) == 0) {
+    MedalAlertEvent dropped;
+    xQueueReceive(alertQueue, &dropped, 0);
+  }
+  return xQueueSend(alertQueue, &ev, 0) == pdTRUE;
 }
 
 static bool dequeueAlert(MedalAlertEvent &out) {
-  if (alertCount == 0) return false;
-  out = alertQueue[alertHead];
-  alertHead = (uint8_t)((alertHead + 1) % kAlertQueueSize);
-  alertCount--;
-  return true;
+  if (!alertQueue) return false;
+  return xQueueReceive(alertQueue, &out, 0) == pdTRUE;
+}
+
+static bool olderThan(uint32_t nowMs, uint32_t stampMs, uint32_t ageMs) {
+  // Stamps are written on the other core and may be slightly ahead of nowMs.
+  return stampMs == 0 || (int32_t)(nowMs - stampMs) > (int32_t)ageMs;
+}
+
+// Data counts as stale after missing a few polls at the current cadence, so
+// a slow idle interval does not flag every page as stale.
+static uint32_t staleAfterMs(uint32_t pollIntervalMs) {
+  return max(kStaleAfterMs, pollIntervalMs * 3);
 }
 
 static bool medalsStale(uint32_t nowMs) {
-  return !hasMedals || (lastGoodMedalsMs == 0) || (nowMs - lastGoodMedalsMs > kStaleAfterMs);
+  return !medalsSeq ||
+         olderThan(nowMs, lastGoodMedalsMs.load(), staleAfterMs(medalsPollIntervalMs.load()));
 }
 
 static bool scheduleStale(uint32_t nowMs) {
-  return !hasSchedule || (lastGoodScheduleMs == 0) || (nowMs - lastGoodScheduleMs > kStaleAfterMs);
+  return !scheduleSeq ||
+         olderThan(nowMs, lastGoodScheduleMs.load(), staleAfterMs(schedulePollIntervalMs.load()));
+}
+
+static bool currentPageStale(uint32_t nowMs) {
+  return (currentPage == ScreenPage::MEDALS) ? medalsStale(nowMs) : scheduleStale(nowMs);
+}
+
+static void noteDraw(uint8_t page, uint32_t startUs) {
+  const uint32_t tookUs = micros() - startUs;
+  DrawStats &stats = drawStats[page];
+  stats.count++;
+  stats.totalUs += tookUs;
+  stats.maxUs = max(stats.maxUs, tookUs);
+}
+
+// Logs draw times per page and the flag cache's hit rate over the window
+// since the last report, then starts over. Also logs the heap: free now, the
+// low-water mark since boot and the largest block, whose gap to the free
+// total is what fragmentation costs.
+static void reportDrawStats(uint32_t nowMs) {
+  if (nowMs - lastDrawReportMs < kDrawReportIntervalMs) return;
+  lastDrawReportMs = nowMs;
+  static const char *const kNames[] = {"medals", "schedule", "alert"};
+  for (uint8_t i = 0; i < 3; ++i) {
+    const DrawStats &stats = drawStats[i];
+    if (!stats.count) continue;
+    Serial.printf("UI: %s %u draws, avg %.1f ms, max %.1f ms\n",
+                  kNames[i],
+                  (unsigned)stats.count,
+                  stats.totalUs / 1000.0f / stats.count,
+                  stats.maxUs / 1000.0f);
+  }
+  memset(drawStats, 0, sizeof(drawStats));
+
+  // The cache counts since boot; report this window's share.
+  const FlagTileCache::Stats flags = Assets::flagCacheStats();
+  const uint32_t hits = flags.hits - lastFlagStats.hits;
+  const uint32_t lookups = hits + (flags.misses - lastFlagStats.misses);
+  const uint32_t evicted = flags.evictions - lastFlagStats.evictions;
+  lastFlagStats = flags;
+  Serial.printf("UI: flag tiles %u%% hits (%lu/%lu), %u tiles, %lu/%lu bytes, %lu evicted\n",
+                lookups ? (unsigned)(hits * 100ULL / lookups) : 0u,
+                (unsigned long)hits,
+                (unsigned long)lookups,
+                (unsigned)flags.tiles,
+                (unsigned long)flags.bytesUsed,
+                (unsigned long)flags.budget,
+                (unsigned long)evicted);
+
+  const uint32_t freeHeap = ESP.getFreeHeap();
+  const uint32_t largest = ESP.getMaxAllocHeap();
+  Serial.printf("HEAP: free %lu, low-water %lu, largest block %lu (%u%% fragmented)\n",
+                (unsigned long)freeHeap,
+                (unsigned long)ESP.getMinFreeHeap(),
+                (unsigned long)largest,
+                freeHeap > largest ? (unsigned)(100ULL - largest * 100ULL / freeHeap) : 0u);
 }
 
 static void renderCurrentPage(uint32_t nowMs) {
   const bool wifi = wifiConnectedNow();
+  lastRenderedStale = currentPageStale(nowMs);
+  const uint32_t startUs = micros();
   if (currentPage == ScreenPage::MEDALS) {
-    ui.drawMedals(medals, FOCUS_TEAM_ABBR, wifi, medalsStale(nowMs));
+    ui.drawMedals(medals, favorites, wifi, medalsStale(nowMs));
   } else {
     ui.drawSchedule(scheduleToday, wifi, scheduleStale(nowMs));
   }
+  noteDraw((uint8_t)currentPage, startUs);
 }
 
 static void togglePage(uint32_t nowMs) {
@@ -136,47 +278,301 @@ static void togglePage(uint32_t nowMs) {
   renderCurrentPage(nowMs);
 }
 
-static bool pollMedals(uint32_t nowMs) {
-  MedalTableState fresh;
-  if (!client.fetchMedalTable(fresh, FOCUS_TEAM_ABBR)) {
-    Serial.println("MEDALS: fetch failed");
-    return false;
+static const char *medalTypeName(MedalType type) {
+  switch (type) {
+    case MedalType::GOLD: return "gold";
+    case MedalType::SILVER: return "silver";
+    case MedalType::BRONZE: return "bronze";
+    default: return "medal";
+  }
+}
+
+// Drains the diff events of one poll: the favourites' gains become alerts,
+// everything else is summarised in one log line.
+static void handleMedalEvents(const MedalTableState &curr) {
+  MedalChangeEvent ev;
+  MedalChangeEvent gains[kMaxFavorites];
+  uint8_t gainCount = 0;
+  uint8_t medalChanges = 0;
+  uint8_t rankMoves = 0;
+  uint8_t entered = 0;
+  while (medalEvents.pop(ev)) {
+    if (ev.kind == MedalEventKind::RANK) rankMoves++;
+    if (ev.kind == MedalEventKind::ENTERED || ev.kind == MedalEventKind::LEFT) entered++;
+    if (ev.kind != MedalEventKind::MEDALS) continue;
+    medalChanges++;
+    if (ev.favorite >= 0 && gainCount < kMaxFavorites) gains[gainCount++] = ev;
   }
 
-  if (hasMedals) {
-    MedalAlertEvent alert;
-    if (client.buildFavoriteMedalAlert(medals, fresh, FOCUS_TEAM_ABBR, alert)) {
-      enqueueAlert(alert);
-      Serial.printf("MEDALS: %s medal detected (%s)\n",
-                    FOCUS_TEAM_ABBR,
-                    alert.sportName.c_str());
+  if (gainCount) {
+    // One pass for all favourites, so a sport is asked for once per poll.
+    MedalAlertEvent alerts[kMaxAlertsPerPoll];
+    const uint8_t count = client.buildFavoriteMedalAlerts(
+        gains, gainCount, curr, netSchedule, favorites, alerts, kMaxAlertsPerPoll);
+    for (uint8_t i = 0; i < count; ++i) {
+      enqueueAlert(alerts[i]);
+      Serial.printf("MEDALS: %s %s x%u detected (%s)\n",
+                    alerts[i].countryCode,
+                    medalTypeName(alerts[i].medalType),
+                    (unsigned)alerts[i].delta,
+                    alerts[i].sportName);
     }
   }
+  if (medalChanges || rankMoves || entered) {
+    Serial.printf("MEDALS: %u medal change(s), %u rank move(s), %u in/out of table\n",
+                  (unsigned)medalChanges,
+                  (unsigned)rankMoves,
+                  (unsigned)entered);
+  }
+  if (medalEvents.dropped() != droppedMedalEvents) {
+    droppedMedalEvents = medalEvents.dropped();
+    Serial.printf("MEDALS: event queue full, %u dropped so far\n", (unsigned)droppedMedalEvents);
+  }
+}
+
+// Every country in the table, shown or not, plus favourites still outside
+// it: the UI then only ever draws flags that are already in SPIFFS.
+static void prefetchMedalFlags(const MedalTableState &table) {
+  for (uint8_t i = 0; i < table.rowCount; ++i) {
+    const char *code = table.rows[i].countryCode;
+    Assets::prefetchFlag(code, medalFlagUrl(code), OlympicScoreboardUi::kTableFlagSize);
+  }
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    Assets::prefetchFlag(favorites.code(f), medalFlagUrl(favorites.code(f)), OlympicScoreboardUi::kTableFlagSize);
+  }
+}
+
+static FetchResult pollMedals(uint32_t nowMs) {
+  static MedalTableState fresh;
+  const FetchResult result = client.fetchMedalTable(fresh, favorites);
+  if (result == FetchResult::FAILED) {
+    Serial.println("MEDALS: fetch failed");
+    return result;
+  }
 
-  medals = fresh;
-  hasMedals = true;
+  if (result == FetchResult::OK) {
+    uint32_t changedRows = 0;
+    const bool changed = !netHasMedals ||
+                         MedalDiff::diff(netMedals, fresh, favorites, medalEvents, changedRows) > 0 ||
+                         changedRows != 0;
+    if (changed) {
+      fresh.revision = netMedals.revision + 1;
+      fresh.changedRows = netHasMedals ? changedRows : 0xFFFFFFFFu;
+      handleMedalEvents(fresh);
+      netMedals = fresh;
+      netHasMedals = true;
+      publishedMedals.publish(netMedals);
+      StateStore::saveMedals(netMedals, nowMs);
+      prefetchMedalFlags(netMedals);
+    }
+  }
   lastGoodMedalsMs = nowMs;
 
-  if (!sportBaselinePrimed) {
-    sportBaselinePrimed = client.primeFavoriteSportBaseline(FOCUS_TEAM_ABBR);
+  if (netHasMedals && !sportBaselinePrimed) {
+    MedalAlertEvent missed[kMaxAlertsPerPoll];
+    uint8_t missedCount = 0;
+    sportBaselinePrimed =
+        client.syncSportBaseline(netMedals, netSchedule, favorites, missed, kMaxAlertsPerPoll, missedCount);
     Serial.printf("MEDALS: sport baseline %s\n", sportBaselinePrimed ? "ready" : "unavailable");
+    for (uint8_t i = 0; i < missedCount; ++i) {
+      enqueueAlert(missed[i]);
+      Serial.printf("MEDALS: %s %s won while offline (%s)\n",
+                    missed[i].countryCode,
+                    medalTypeName(missed[i].medalType),
+                    missed[i].sportName);
+    }
   }
 
+  return result;
+}
+
+// Merges a page into the live schedule; only a page that changed something
+// is published and saved.
+static bool adoptSchedule(const DailyScheduleState &page, uint32_t nowMs) {
+  if (!mergeSchedulePage(netSchedule, page)) return false;
+  publishedSchedule.publish(netSchedule);
+  StateStore::saveSchedule(netSchedule, nowMs);
+  return true;
+}
+
+// A medal session that has just gone final is the best hint that the medal
+// table is about to change, so the next medals poll is brought forward and
+// the planner keeps medals hot for a while.
+static void pollMedalsOnFinishedSession(const DailyScheduleState &schedule, uint32_t nowMs) {
+  const uint64_t changed = schedule.changes.statusChanged;
+  for (uint8_t i = 0; i < schedule.rowCount; ++i) {
+    const CompetitionRow &row = schedule.rows[i];
+    if (!(changed & (1ULL << i)) || !row.isMedalSession || row.status != EventStatus::FINAL) continue;
+    Serial.printf("SCHEDULE: %s %s final, polling medals\n", row.sportCode, row.title);
+    pollScheduler.noteMedalFinal(time(nullptr));
+    lastPollPlanMs = nowMs - kPollPlanIntervalMs;
+    lastMedalsPollMs = nowMs - pollScheduler.medalsIntervalMs();
+    return;
+  }
+}
+
+// Moves the live page on once every row on it is final, so a long day keeps
+// showing what is on now. Later rows are paged in from the day's segment.
+static bool advanceSchedulePage(uint32_t nowMs) {
+  if (!netSchedule.valid || netSchedule.rowCount == 0) return false;
+  const uint16_t nextRow = netSchedule.firstRow + netSchedule.rowCount;
+  if (nextRow >= netSchedule.totalRows) return false;
+  for (uint8_t i = 0; i < netSchedule.rowCount; ++i) {
+    if (netSchedule.rows[i].status != EventStatus::FINAL) return false;
+  }
+  if (!ScheduleCache::loadPage(netSchedule.dateYmd, nextRow, scheduleScratch)) return false;
+  Serial.printf("SCHEDULE: paged in rows %u-%u of %u\n",
+                (unsigned)nextRow,
+                (unsigned)(nextRow + scheduleScratch.rowCount - 1),
+                (unsigned)scheduleScratch.totalRows);
+  adoptSchedule(scheduleScratch, nowMs);
   return true;
 }
 
-static bool pollSchedule(uint32_t nowMs) {
-  DailyScheduleState fresh;
+static FetchResult pollSchedule(uint32_t nowMs) {
+  static DailyScheduleState fresh;
   const String ymd = todayYmd();
-  if (!client.fetchDailySchedule(fresh, ymd)) {
+  const uint16_t firstRow = (ymd == netSchedule.dateYmd) ? netSchedule.firstRow : 0;
+  ScheduleCache::SegmentWriter writer;
+  const FetchResult result = client.fetchDailySchedule(fresh, ymd, clockValid() ? &writer : nullptr, firstRow);
+  if (result == FetchResult::FAILED) {
     Serial.println("SCHEDULE: fetch failed");
-    return false;
+    return result;
   }
 
-  scheduleToday = fresh;
-  hasSchedule = true;
+  if (result == FetchResult::OK) {
+    // The day shrank below the page being shown; start over from the top.
+    if (fresh.rowCount == 0 && fresh.totalRows > 0) {
+      ScheduleCache::loadPage(ymd.c_str(), 0, fresh);
+    }
+    if (adoptSchedule(fresh, nowMs)) {
+      const ScheduleChanges &changes = netSchedule.changes;
+      if (!changes.reset) {
+        Serial.printf("SCHEDULE: merged, %u rows redrawn (+%u -%u, %u status, %u time)\n",
+                      (unsigned)__builtin_popcountll(changes.redraw),
+                      (unsigned)__builtin_popcountll(changes.added),
+                      (unsigned)changes.removed,
+                      (unsigned)__builtin_popcountll(changes.statusChanged),
+                      (unsigned)__builtin_popcountll(changes.timeChanged));
+        pollMedalsOnFinishedSession(netSchedule, nowMs);
+      }
+    }
+    advanceSchedulePage(nowMs);
+  }
   lastGoodScheduleMs = nowMs;
-  return true;
+  return result;
+}
+
+// Shows today's cached segment as soon as the date changes instead of
+// waiting for the first fetch of the new day.
+static void rollScheduleOver(const String &today, uint32_t nowMs) {
+  if (!ScheduleCache::loadPage(today.c_str(), 0, scheduleScratch)) return;
+  Serial.printf("SCHEDULE: %s loaded from flash (%u rows)\n", today.c_str(), (unsigned)scheduleScratch.totalRows);
+  adoptSchedule(scheduleScratch, nowMs);
+  advanceSchedulePage(nowMs);
+}
+
+// Re-runs the next-medal lookup when a segment was rewritten or the event it
+// found has started. Returns true if the result changed.
+static bool refreshNextMedal() {
+  const time_t now = time(nullptr);
+  const uint32_t generation = ScheduleCache::generation();
+  const bool started = netSchedule.hasNextMedal && netSchedule.nextMedal.startEpoch < now;
+  if (generation == nextMedalGeneration && !started) return false;
+  nextMedalGeneration = generation;
+
+  String days[1 + ScheduleCache::kDaysAhead];
+  for (uint8_t i = 0; i <= ScheduleCache::kDaysAhead; ++i) days[i] = localYmd(i);
+  CompetitionRow next;
+  const bool found = ScheduleCache::findNextMedal(days, 1 + ScheduleCache::kDaysAhead, now, next);
+  const bool changed = found != netSchedule.hasNextMedal ||
+                       (found && memcmp(&next, &netSchedule.nextMedal, sizeof(next)) != 0);
+  netSchedule.hasNextMedal = found;
+  netSchedule.nextMedal = found ? next : CompetitionRow();
+  return changed;
+}
+
+// Keeps the days after today cached, fetching at most one per call: missing
+// days first, then each every few hours.
+static void pollFutureSchedule(uint32_t nowMs) {
+  FutureScheduleDay window[ScheduleCache::kDaysAhead] = {};
+  for (uint8_t i = 0; i < ScheduleCache::kDaysAhead; ++i) {
+    const String ymd = localYmd(i + 1);
+    strlcpy(window[i].dateYmd, ymd.c_str(), sizeof(window[i].dateYmd));
+    for (const FutureScheduleDay &known : futureDays) {
+      if (strcmp(known.dateYmd, window[i].dateYmd) == 0) window[i] = known;
+    }
+  }
+  memcpy(futureDays, window, sizeof(futureDays));
+
+  for (FutureScheduleDay &day : futureDays) {
+    const uint32_t waitMs = day.ok ? kFutureScheduleRefreshMs : kFutureScheduleRetryMs;
+    if (day.attempted && nowMs - day.lastAttemptMs < waitMs) continue;
+    ScheduleCache::SegmentWriter writer;
+    const FetchResult result = client.fetchDailySchedule(scheduleScratch, day.dateYmd, &writer);
+    day.attempted = true;
+    day.lastAttemptMs = nowMs;
+    day.ok = result != FetchResult::FAILED;
+    if (!day.ok) Serial.printf("SCHEDULE: %s fetch failed\n", day.dateYmd);
+    return;
+  }
+}
+
+// Day rollover, pruning, paging and the cross-day lookups; all flash or RAM
+// work except for the occasional future-day fetch.
+static void maintainScheduleCache(uint32_t nowMs) {
+  if (!clockValid()) return;
+  const String today = todayYmd();
+  if (today != prunedForYmd) {
+    ScheduleCache::prune(today.c_str());
+    strlcpy(prunedForYmd, today.c_str(), sizeof(prunedForYmd));
+  }
+  if (today != netSchedule.dateYmd) rollScheduleOver(today, nowMs);
+  advanceSchedulePage(nowMs);
+  if (refreshNextMedal()) {
+    netSchedule.revision++;
+    netSchedule.changes = ScheduleChanges();
+    netSchedule.changes.reset = true;
+    publishedSchedule.publish(netSchedule);
+  }
+  if (netSchedule.valid && today == netSchedule.dateYmd) pollFutureSchedule(nowMs);
+}
+
+// Owns Wi-Fi and every HTTP request so the UI loop never waits on the network.
+static void networkTask(void *) {
+  client.loadSportBaseline(favorites);
+  wifiConnectWithFallback();
+  const uint32_t startMs = millis();
+  lastMedalsPollMs = startMs - pollScheduler.medalsIntervalMs();
+  lastSchedulePollMs = startMs - pollScheduler.scheduleIntervalMs();
+
+  for (;;) {
+    wifiTick();
+    const uint32_t nowMs = millis();
+    if (wifiConnectedNow()) {
+      ensureTimeConfigured(nowMs);
+
+      if (nowMs - lastPollPlanMs >= kPollPlanIntervalMs) {
+        lastPollPlanMs = nowMs;
+        maintainScheduleCache(nowMs);
+        pollScheduler.update(netSchedule, time(nullptr), todayYmd());
+        medalsPollIntervalMs = pollScheduler.medalsIntervalMs();
+        schedulePollIntervalMs = pollScheduler.scheduleIntervalMs();
+      }
+
+      if (nowMs - lastMedalsPollMs >= pollScheduler.medalsIntervalMs()) {
+        lastMedalsPollMs = nowMs;
+        pollMedals(nowMs);
+      }
+
+      if (nowMs - lastSchedulePollMs >= pollScheduler.scheduleIntervalMs()) {
+        lastSchedulePollMs = nowMs;
+        pollSchedule(nowMs);
+      }
+    }
+    StateStore::flushPending(netMedals, netSchedule, nowMs);
+    vTaskDelay(pdMS_TO_TICKS(kNetworkTaskIdleMs));
+  }
 }
 
 static void maybeShowAlert(uint32_t nowMs) {
@@ -188,7 +584,9 @@ static void maybeShowAlert(uint32_t nowMs) {
   activeAlert = nextAlert;
   alertActive = true;
   alertUntilMs = nowMs + max(kAlertPopupMs, kAlertAudioMs);
-  ui.drawMedalAlert(activeAlert, FOCUS_TEAM_ABBR);
+  const uint32_t startUs = micros();
+  ui.drawMedalAlert(activeAlert);
+  noteDraw(2, startUs);
   Anthem::playNowForMs(kAlertAudioMs);
 }
 
@@ -210,49 +608,51 @@ void setup() {
 
   Assets::begin(tft);
   Anthem::begin();
+  if (!favorites.parse(FOCUS_TEAM_ABBRS)) Serial.println("FAV: FOCUS_TEAM_ABBRS names no country");
 
-  ui.drawBootSplash("MILANO CORTINA 2026", "CONNECTING WIFI");
-  wifiConnectWithFallback();
+  // Show the last snapshot from flash (flagged STALE) instead of the splash
+  // while Wi-Fi comes up.
+  const bool restoredMedals = StateStore::loadMedals(medals);
+  const bool restoredSchedule = StateStore::loadSchedule(scheduleToday);
+  if (restoredSchedule) netSchedule = scheduleToday;
 
   const uint32_t nowMs = millis();
-  ensureTimeConfigured(nowMs);
-
-  if (wifiConnectedNow()) {
-    const bool medalsOk = pollMedals(nowMs);
-    const bool scheduleOk = pollSchedule(nowMs);
-    lastMedalsPollMs = medalsOk ? nowMs : (nowMs - kMedalsPollIntervalMs);
-    lastSchedulePollMs = scheduleOk ? nowMs : (nowMs - kSchedulePollIntervalMs);
+  if (restoredMedals || restoredSchedule) {
+    Serial.printf("STATE: restored medals=%d schedule=%d\n", restoredMedals, restoredSchedule);
+    if (!restoredMedals) currentPage = ScreenPage::SCHEDULE;
+    renderCurrentPage(nowMs);
   } else {
-    lastMedalsPollMs = nowMs - kMedalsPollIntervalMs;
-    lastSchedulePollMs = nowMs - kSchedulePollIntervalMs;
+    ui.drawBootSplash("MILANO CORTINA 2026", "CONNECTING WIFI");
   }
+
+  alertQueue = xQueueCreate(kAlertQueueSize, sizeof(MedalAlertEvent));
+  xTaskCreatePinnedToCore(networkTask, "net", kNetworkTaskStack, nullptr, 1, nullptr, 0);
+
   lastRotateMs = nowMs;
   lastWifiConnected = wifiConnectedNow();
-
-  renderCurrentPage(nowMs);
 }
 
 void loop() {
-  wifiTick();
   const uint32_t nowMs = millis();
   const bool wifi = wifiConnectedNow();
   bool shouldRender = false;
   bool resetRotateTimer = false;
 
-  if (wifi) ensureTimeConfigured(nowMs);
-
-  if (wifi && nowMs - lastMedalsPollMs >= kMedalsPollIntervalMs) {
-    lastMedalsPollMs = nowMs;
-    if (pollMedals(nowMs) && !alertActive) {
-      shouldRender = true;
-    }
+  // Only the page on screen needs redrawing; the UI repaints just the cells
+  // whose values changed.
+  const bool medalsUpdated = publishedMedals.readIfNewer(medals, medalsSeq);
+  const bool scheduleUpdated = publishedSchedule.readIfNewer(scheduleToday, scheduleSeq);
+  if ((currentPage == ScreenPage::MEDALS ? medalsUpdated : scheduleUpdated) && !alertActive) {
+    shouldRender = true;
   }
-
-  if (wifi && nowMs - lastSchedulePollMs >= kSchedulePollIntervalMs) {
-    lastSchedulePollMs = nowMs;
-    if (pollSchedule(nowMs) && !alertActive) {
-      shouldRender = true;
-    }
+  if (currentPageStale(nowMs) != lastRenderedStale && !alertActive) {
+    shouldRender = true;
+  }
+  // A prefetched flag landed; the medals page swaps the badges it can.
+  const uint32_t flagGeneration = Assets::flagGeneration();
+  if (flagGeneration != seenFlagGeneration) {
+    seenFlagGeneration = flagGeneration;
+    if (currentPage == ScreenPage::MEDALS && !alertActive) shouldRender = true;
   }
 
   maybeShowAlert(nowMs);
@@ -279,6 +679,7 @@ void loop() {
     renderCurrentPage(nowMs);
     if (resetRotateTimer) lastRotateMs = nowMs;
   }
+  reportDrawStats(nowMs);
 
   delay(20);
 }
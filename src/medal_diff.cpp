@@ -0,0 +1,152 @@
+#include "medal_diff.h"
+
+namespace {
+
+// Open-addressed NOC -> row map; twice the rows keeps probe runs short.
+static const uint8_t kIndexBits = 6;
+static const uint8_t kIndexSlots = 1 << kIndexBits;
+static const uint8_t kNoRow = 0xFF;
+
+static_assert(kIndexSlots >= 2 * kMaxMedalRows, "medal row index too small");
+
+struct RowIndex {
+  uint32_t keys[kIndexSlots];
+  uint8_t rows[kIndexSlots];
+
+  static uint8_t slotFor(uint32_t key) { return (uint8_t)((key * 2654435761u) >> (32 - kIndexBits)); }
+
+  void build(const MedalTableState &table) {
+    memset(rows, kNoRow, sizeof(rows));
+    for (uint8_t i = 0; i < table.rowCount; ++i) {
+      const uint32_t key = packNoc(table.rows[i].countryCode);
+      uint8_t slot = slotFor(key);
+      while (rows[slot] != kNoRow) slot = (slot + 1) & (kIndexSlots - 1);
+      keys[slot] = key;
+      rows[slot] = i;
+    }
+  }
+
+  int find(uint32_t key) const {
+    for (uint8_t slot = slotFor(key); rows[slot] != kNoRow; slot = (slot + 1) & (kIndexSlots - 1)) {
+      if (keys[slot] == key) return rows[slot];
+    }
+    return -1;
+  }
+};
+
+static bool sameRow(const MedalRow &a, const MedalRow &b) {
+  return a.gold == b.gold && a.silver == b.silver && a.bronze == b.bronze && a.total == b.total &&
+         a.rank == b.rank && strcmp(a.countryCode, b.countryCode) == 0 &&
+         strcmp(a.countryName, b.countryName) == 0;
+}
+
+}  // namespace
+
+namespace MedalDiff {
+
+bool EventQueue::push(const MedalChangeEvent &ev) {
+  if (_count == kCapacity) {
+    _dropped++;
+    return false;
+  }
+  _events[(_head + _count) % kCapacity] = ev;
+  _count++;
+  return true;
+}
+
+bool EventQueue::pop(MedalChangeEvent &out) {
+  if (_count == 0) return false;
+  out = _events[_head];
+  _head = (_head + 1) % kCapacity;
+  _count--;
+  return true;
+}
+
+void EventQueue::clear() {
+  _head = 0;
+  _count = 0;
+}
+
+uint8_t diff(const MedalTableState &prev,
+             const MedalTableState &curr,
+             const FavoriteSet &favorites,
+             EventQueue &events,
+             uint32_t &changedRows) {
+  changedRows = 0;
+  if (!curr.valid) return 0;
+  if (!prev.valid) {
+    changedRows = (uint32_t)((1ULL << curr.rowCount) - 1);
+    return 0;
+  }
+
+  uint8_t queued = 0;
+  const uint8_t favoriteCount = min(favorites.count(), min(prev.favoriteCount, curr.favoriteCount));
+  for (uint8_t f = 0; f < favoriteCount; ++f) {
+    const MedalRow &before = prev.favorites[f].row;
+    const MedalRow &after = curr.favorites[f].row;
+    MedalChangeEvent ev;
+    ev.favorite = (int8_t)f;
+    strlcpy(ev.countryCode, favorites.code(f), sizeof(ev.countryCode));
+    ev.row = curr.favorites[f].index;
+    ev.gold = (int16_t)(after.gold - before.gold);
+    ev.silver = (int16_t)(after.silver - before.silver);
+    ev.bronze = (int16_t)(after.bronze - before.bronze);
+    ev.fromRank = before.rank;
+    ev.toRank = after.rank;
+    const bool medals = ev.gold || ev.silver || ev.bronze;
+    if (medals || ev.fromRank != ev.toRank) {
+      ev.kind = medals ? MedalEventKind::MEDALS : MedalEventKind::RANK;
+      if (events.push(ev)) queued++;
+    }
+  }
+
+  static RowIndex index;
+  index.build(prev);
+  uint32_t matched = 0;
+  for (uint8_t i = 0; i < curr.rowCount; ++i) {
+    const MedalRow &row = curr.rows[i];
+    if (i >= prev.rowCount || !sameRow(prev.rows[i], row)) changedRows |= 1UL << i;
+
+    const uint32_t key = packNoc(row.countryCode);
+    const int j = index.find(key);
+    if (j >= 0) matched |= 1UL << j;
+    if (favorites.indexOf(key) >= 0) continue;
+
+    MedalChangeEvent ev;
+    strlcpy(ev.countryCode, row.countryCode, sizeof(ev.countryCode));
+    ev.row = (int8_t)i;
+    ev.toRank = row.rank;
+    if (j < 0) {
+      ev.kind = MedalEventKind::ENTERED;
+    } else {
+      const MedalRow &before = prev.rows[j];
+      ev.gold = (int16_t)(row.gold - before.gold);
+      ev.silver = (int16_t)(row.silver - before.silver);
+      ev.bronze = (int16_t)(row.bronze - before.bronze);
+      ev.fromRank = before.rank;
+      if (ev.gold || ev.silver || ev.bronze) {
+        ev.kind = MedalEventKind::MEDALS;
+      } else if (ev.fromRank != ev.toRank) {
+        ev.kind = MedalEventKind::RANK;
+      } else {
+        continue;
+      }
+    }
+    if (events.push(ev)) queued++;
+  }
+
+  for (uint8_t j = 0; j < prev.rowCount; ++j) {
+    if (j >= curr.rowCount) changedRows |= 1UL << j;
+    if (matched & (1UL << j)) continue;
+    const MedalRow &gone = prev.rows[j];
+    if (favorites.indexOf(gone.countryCode) >= 0) continue;
+    MedalChangeEvent ev;
+    ev.kind = MedalEventKind::LEFT;
+    strlcpy(ev.countryCode, gone.countryCode, sizeof(ev.countryCode));
+    ev.fromRank = gone.rank;
+    if (events.push(ev)) queued++;
+  }
+  return queued;
+}
+
+}  // namespace MedalDiff
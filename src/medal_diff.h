@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "olympic_scoreboard_client.h"
+
+// Compares consecutive medal tables row by row, keyed by NOC code, and turns
+// the differences into MedalChangeEvents: medal count changes, rank moves,
+// and countries entering or leaving the kept rows. One linear pass over each
+// table; no requests.
+
+namespace MedalDiff {
+
+// Fixed-capacity FIFO of change events. A full queue refuses new events and
+// counts them as dropped; the favourites' events are always diffed first.
+class EventQueue {
+public:
+  static const uint8_t kCapacity = 32;
+
+  bool push(const MedalChangeEvent &ev);
+  bool pop(MedalChangeEvent &out);
+  uint8_t size() const { return _count; }
+  uint16_t dropped() const { return _dropped; }
+  void clear();
+
+private:
+  MedalChangeEvent _events[kCapacity];
+  uint8_t _head = 0;
+  uint8_t _count = 0;
+  uint16_t _dropped = 0;
+};
+
+// Queues the changes from `prev` to `curr` and returns how many were queued.
+// Favourites are compared on their own standings, so they are covered even
+// when they sit outside the kept rows. `changedRows` gets a bit for every row
+// position whose contents differ, including positions the table no longer
+// fills.
+uint8_t diff(const MedalTableState &prev,
+             const MedalTableState &curr,
+             const FavoriteSet &favorites,
+             EventQueue &events,
+             uint32_t &changedRows);
+
+}  // namespace MedalDiff
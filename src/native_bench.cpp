@@ -0,0 +1,388 @@
+// Ingest benchmark for the `native_bench` env: replays fixture feeds through
+// the real fetch paths and reports time, heap and bytes per call. Fixtures
+// come from tools/make_bench_fixtures.py.
+#ifdef NATIVE_BENCH
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+
+#include <vector>
+
+#include "chunked_stream.h"
+#include "olympic_scoreboard_client.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+struct AllocStats {
+  size_t count = 0;
+  size_t live = 0;
+  size_t peak = 0;
+};
+
+AllocStats g_alloc;
+
+}  // namespace
+
+#if defined(__GLIBC__)
+// Interpose the C allocator so ArduinoJson's pool and std::string storage are
+// both counted.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+static void trackAlloc(void *ptr) {
+  if (!ptr) return;
+  g_alloc.count++;
+  g_alloc.live += malloc_usable_size(ptr);
+  if (g_alloc.live > g_alloc.peak) g_alloc.peak = g_alloc.live;
+}
+
+static void trackFree(void *ptr) {
+  if (ptr) g_alloc.live -= malloc_usable_size(ptr);
+}
+
+void *malloc(size_t size) {
+  void *ptr = __libc_malloc(size);
+  trackAlloc(ptr);
+  return ptr;
+}
+
+void *calloc(size_t n, size_t size) {
+  void *ptr = __libc_calloc(n, size);
+  trackAlloc(ptr);
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  trackFree(ptr);
+  void *out = __libc_realloc(ptr, size);
+  trackAlloc(out ? out : ptr);
+  return out;
+}
+
+void free(void *ptr) {
+  trackFree(ptr);
+  __libc_free(ptr);
+}
+}
+#endif
+
+namespace {
+
+static const char *kFavorite = "CAN";
+
+static const FavoriteSet &favoriteSet() {
+  static FavoriteSet set;
+  if (!set.count()) set.parse(kFavorite);
+  return set;
+}
+static const char *kScheduleDate = "2026-02-10";
+// A weak 2.4 GHz link at the edge of the CYD's antenna; wifi_ms adds the
+// time to move the bytes at this rate to the measured CPU time.
+static const uint32_t kWeakLinkBytesPerSec = 40 * 1024;
+
+enum class BenchCase : uint8_t {
+  MEDALS_COUNTRY,
+  SCHEDULE,
+  SPORT_SWEEP
+};
+
+struct Sample {
+  uint32_t micros;
+  uint32_t sleptUs;
+  size_t allocs;
+  size_t peakHeap;
+  size_t bytes;
+  size_t socketReads;
+  bool ok;
+  uint16_t rows;
+};
+
+// One cold fetch on a fresh client, so validators never turn it into a 304.
+static Sample runOnce(BenchCase which) {
+  OlympicScoreboardClient client;
+  static MedalTableState medals;
+  static DailyScheduleState schedule;
+  Sample sample = {};
+
+  MedalTableState favoriteOnly;
+  if (which == BenchCase::SPORT_SWEEP) {
+    favoriteOnly.valid = true;
+    favoriteOnly.favoriteCount = 1;
+    favoriteOnly.favorites[0].present = true;
+  }
+
+  const size_t bytesBefore = WiFiClient::nativeBytesRead();
+  const size_t readsBefore = WiFiClient::nativeReadCalls();
+  const uint64_t sleptBefore = NativeClock::sleptUs();
+  const size_t liveBefore = g_alloc.live;
+  g_alloc.count = 0;
+  g_alloc.peak = g_alloc.live;
+  const uint32_t startUs = micros();
+  HardwareSerial::nativeMuted() = true;
+
+  switch (which) {
+    case BenchCase::MEDALS_COUNTRY:
+      sample.ok = client.fetchMedalTable(medals, favoriteSet()) == FetchResult::OK;
+      sample.rows = medals.rowCount;
+      break;
+    case BenchCase::SCHEDULE:
+      sample.ok = client.fetchDailySchedule(schedule, kScheduleDate) == FetchResult::OK;
+      sample.rows = schedule.rowCount;
+      break;
+    case BenchCase::SPORT_SWEEP: {
+      MedalAlertEvent missed[3];
+      uint8_t missedCount = 0;
+      sample.ok = client.syncSportBaseline(favoriteOnly, schedule, favoriteSet(), missed, 3, missedCount);
+      sample.rows = kWinterSportCount;
+      break;
+    }
+  }
+
+  HardwareSerial::nativeMuted() = false;
+  // delay() pacing between requests is reported apart from parse time.
+  sample.sleptUs = (uint32_t)(NativeClock::sleptUs() - sleptBefore);
+  sample.micros = micros() - startUs - sample.sleptUs;
+  sample.allocs = g_alloc.count;
+  sample.peakHeap = g_alloc.peak - liveBefore;
+  sample.bytes = WiFiClient::nativeBytesRead() - bytesBefore;
+  sample.socketReads = WiFiClient::nativeReadCalls() - readsBefore;
+  return sample;
+}
+
+static void runCase(const char *set, const char *label, BenchCase which, uint16_t iterations) {
+  std::vector<Sample> samples;
+  (void)runOnce(which);  // warm-up: loads the fixture and TLS pool entries
+  for (uint16_t i = 0; i < iterations; ++i) samples.push_back(runOnce(which));
+  std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) { return a.micros < b.micros; });
+
+  const Sample &median = samples[samples.size() / 2];
+  const char *framing = NativeHttp::gzip() ? (NativeHttp::chunked() ? "gz+chnk" : "gzip")
+                                           : (NativeHttp::chunked() ? "chunked" : "plain");
+  const unsigned long wifiMs =
+    (unsigned long)(median.micros / 1000 + (uint64_t)median.bytes * 1000 / kWeakLinkBytesPerSec);
+  Serial.printf("%-8s %-16s %-7s %8lu %8lu %8lu %8lu %8zu %8zu %9zu %9zu %7lu %5u\n",
+                set,
+                label,
+                framing,
+                (unsigned long)samples.front().micros,
+                (unsigned long)median.micros,
+                (unsigned long)samples.back().micros,
+                (unsigned long)median.sleptUs,
+                median.allocs,
+                median.peakHeap,
+                median.bytes,
+                median.socketReads,
+                wifiMs,
+                (unsigned)median.rows);
+  if (!median.ok) Serial.printf("         ^ fetch failed; check fixtures in %s\n", NativeHttp::dir().c_str());
+}
+
+// The decoder as it was before ChunkedStream buffered its input: one socket
+// read per payload byte and a readBytesUntil() per chunk header. Kept only as
+// the baseline for the decoder comparison below.
+class ByteChunkedStream : public Stream {
+public:
+  explicit ByteChunkedStream(Stream &src) : _src(src) {}
+
+  int available() override { return _src.available(); }
+  int read() override {
+    if (_done) return -1;
+    if (_remaining == 0 && !readChunkHeader()) return -1;
+    const int c = _src.read();
+    if (c < 0) return -1;
+    if (--_remaining == 0) {
+      (void)_src.read();
+      (void)_src.read();
+    }
+    return c;
+  }
+  int peek() override { return -1; }
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  bool readChunkHeader() {
+    char line[24];
+    size_t n = _src.readBytesUntil('\n', line, sizeof(line) - 1);
+    if (n == 0) return false;
+    line[n] = '\0';
+    char *semi = strchr(line, ';');
+    if (semi) *semi = '\0';
+    _remaining = (int)strtol(line, nullptr, 16);
+    if (_remaining == 0) {
+      _done = true;
+      return false;
+    }
+    return true;
+  }
+
+  Stream &_src;
+  int _remaining = 0;
+  bool _done = false;
+};
+
+enum class DecodeMode : uint8_t {
+  BYTE_READ,      // legacy decoder, read() per byte
+  BUFFERED_READ,  // ChunkedStream, readBytes(&c, 1) per byte as the parsers do
+  BUFFERED_BULK   // ChunkedStream, 512-byte readBytes()
+};
+
+// A schedule-sized JSON body split into fixed chunks, with an extension on
+// every other chunk and a trailer, the way CDNs occasionally frame them.
+static std::shared_ptr<const std::string> chunkedBody(size_t bodyBytes, size_t chunkBytes) {
+  std::string body;
+  while (body.size() < bodyBytes) {
+    body += "{\"eventId\":\"ALP-M-DH-0001\",\"title\":\"Men's Downhill\",\"status\":\"LIVE\"},";
+  }
+  body.resize(bodyBytes);
+
+  auto framed = std::make_shared<std::string>();
+  char header[32];
+  size_t index = 0;
+  for (size_t pos = 0; pos < body.size(); pos += chunkBytes, ++index) {
+    const size_t n = std::min(chunkBytes, body.size() - pos);
+    snprintf(header, sizeof(header), (index & 1U) ? "%zx;src=edge\r\n" : "%zx\r\n", n);
+    *framed += header;
+    framed->append(body, pos, n);
+    *framed += "\r\n";
+  }
+  *framed += "0\r\nX-Cache: HIT\r\n\r\n";
+  return framed;
+}
+
+static size_t decodeOnce(const std::shared_ptr<const std::string> &framed, DecodeMode mode, size_t &socketReads) {
+  WiFiClient socket;
+  socket.nativeLoadResponse(framed);
+  const size_t readsBefore = WiFiClient::nativeReadCalls();
+  size_t total = 0;
+  switch (mode) {
+    case DecodeMode::BYTE_READ: {
+      ByteChunkedStream chunked(socket);
+      while (chunked.read() >= 0) total++;
+      break;
+    }
+    case DecodeMode::BUFFERED_READ: {
+      ChunkedStream chunked(socket);
+      Stream &stream = chunked;
+      char c;
+      while (stream.readBytes(&c, 1) == 1) total++;
+      if (!chunked.drain()) total = 0;
+      break;
+    }
+    case DecodeMode::BUFFERED_BULK: {
+      ChunkedStream chunked(socket);
+      char buf[512];
+      size_t n;
+      while ((n = chunked.readBytes(buf, sizeof(buf))) > 0) total += n;
+      if (!chunked.drain()) total = 0;
+      break;
+    }
+  }
+  socketReads = WiFiClient::nativeReadCalls() - readsBefore;
+  return total;
+}
+
+static void runDecodeCase(size_t chunkBytes, DecodeMode mode, const char *label, uint16_t iterations) {
+  static const size_t kBodyBytes = 64 * 1024;
+  const std::shared_ptr<const std::string> framed = chunkedBody(kBodyBytes, chunkBytes);
+  std::vector<uint32_t> times;
+  size_t socketReads = 0;
+  size_t decoded = 0;
+  for (uint16_t i = 0; i <= iterations; ++i) {
+    const uint32_t startUs = micros();
+    decoded = decodeOnce(framed, mode, socketReads);
+    if (i > 0) times.push_back(micros() - startUs);  // first pass is warm-up
+  }
+  std::sort(times.begin(), times.end());
+  Serial.printf("%-8zu %-14s %8lu %8lu %8lu %9zu %9zu%s\n",
+                chunkBytes,
+                label,
+                (unsigned long)times.front(),
+                (unsigned long)times[times.size() / 2],
+                (unsigned long)times.back(),
+                socketReads,
+                decoded,
+                decoded == kBodyBytes ? "" : "  <- short decode");
+}
+
+static void runDecodeComparison(uint16_t iterations) {
+  Serial.println();
+  Serial.println("chunked decode, 64 KB body (sock_rd: calls into the socket per body)");
+  Serial.printf("%-8s %-14s %8s %8s %8s %9s %9s\n", "chunk_B", "decoder", "min_us", "med_us", "max_us", "sock_rd", "bytes");
+  // 1460 is one TCP segment; the NBC CDN mostly emits 4-16 KB chunks.
+  for (const size_t chunkBytes : {256, 1460, 4096, 16384}) {
+    runDecodeCase(chunkBytes, DecodeMode::BYTE_READ, "byte read()", iterations);
+    runDecodeCase(chunkBytes, DecodeMode::BUFFERED_READ, "buffered 1B", iterations);
+    runDecodeCase(chunkBytes, DecodeMode::BUFFERED_BULK, "buffered bulk", iterations);
+  }
+}
+
+}  // namespace
+
+// usage: native_bench [fixtures-root] [iterations] [set...]
+int main(int argc, char **argv) {
+  const std::string root = (argc > 1) ? argv[1] : "fixtures";
+  const uint16_t iterations = (argc > 2) ? (uint16_t)atoi(argv[2]) : 25;
+  std::vector<std::string> sets;
+  for (int i = 3; i < argc; ++i) sets.push_back(argv[i]);
+  if (sets.empty()) sets = {"recorded", "small", "large"};
+
+#if !defined(__GLIBC__)
+  Serial.println("note: allocation counts need glibc; allocs/heap columns read 0");
+#endif
+  Serial.printf("caps: kMaxMedalRows=%u kMaxScheduleRows=%u, %u iterations, median row shown\n",
+                (unsigned)kMaxMedalRows,
+                (unsigned)kMaxScheduleRows,
+                (unsigned)iterations);
+  Serial.printf("%-8s %-16s %-7s %8s %8s %8s %8s %8s %8s %9s %9s %7s %5s\n",
+                "set",
+                "endpoint",
+                "framing",
+                "min_us",
+                "med_us",
+                "max_us",
+                "slept_us",
+                "allocs",
+                "peak_B",
+                "bytes",
+                "sock_rd",
+                "wifi_ms",
+                "rows");
+
+  for (const std::string &set : sets) {
+    NativeHttp::dir() = root + "/" + set;
+    FILE *probe = fopen((NativeHttp::dir() + "/" +
+                         NativeHttp::fixtureName("https://sdf.nbcolympics.com/v1/widget/medals/country?"
+                                                 "competitionCode=OWG2026"))
+                          .c_str(),
+                        "rb");
+    if (!probe) {
+      // fixtures/ is not committed; the recorded set exists only where
+      // tools/make_bench_fixtures.py --record could reach the live feeds.
+      Serial.printf("%-8s skipped: no fixtures in %s\n", set.c_str(), NativeHttp::dir().c_str());
+      continue;
+    }
+    fclose(probe);
+
+    for (const bool gzip : {false, true}) {
+      for (const bool chunked : {false, true}) {
+        NativeHttp::gzip() = gzip;
+        NativeHttp::chunked() = chunked;
+        runCase(set.c_str(), "medals-country", BenchCase::MEDALS_COUNTRY, iterations);
+        runCase(set.c_str(), "schedule", BenchCase::SCHEDULE, iterations);
+        runCase(set.c_str(), "medals-sport x16", BenchCase::SPORT_SWEEP, iterations);
+      }
+    }
+  }
+  runDecodeComparison(iterations);
+  return 0;
+}
+
+#endif  // NATIVE_BENCH
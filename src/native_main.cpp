@@ -0,0 +1,253 @@
+// Host entry point for the `native` PlatformIO env: runs the client, state
+// store, poll scheduler and flag pipeline against fixture files so their
+// behaviour can be inspected without flashing a board. See native/shims for
+// the fakes.
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+#include <FS.h>
+#include <HTTPClient.h>
+#include <TFT_eSPI.h>
+#include <esp_partition.h>
+
+#include <atomic>
+#include <filesystem>
+#include <vector>
+
+#include "anthem.h"
+#include "assets.h"
+#include "config.h"
+#include "flag_atlas.h"
+#include "favorite_set.h"
+#include "olympic_scoreboard_client.h"
+#include "poll_scheduler.h"
+#include "state_store.h"
+
+namespace {
+
+static const char *statusName(EventStatus status) {
+  switch (status) {
+    case EventStatus::LIVE: return "LIVE";
+    case EventStatus::FINAL: return "FINAL";
+    case EventStatus::SCHEDULED: return "SCHEDULED";
+    default: return "-";
+  }
+}
+
+static const char *resultName(FetchResult result) {
+  switch (result) {
+    case FetchResult::OK: return "OK";
+    case FetchResult::NOT_MODIFIED: return "NOT_MODIFIED";
+    default: return "FAILED";
+  }
+}
+
+static void printMedals(const MedalTableState &medals, const FavoriteSet &favorites) {
+  for (uint8_t i = 0; i < medals.rowCount; ++i) {
+    const MedalRow &row = medals.rows[i];
+    Serial.printf("  %2u %-3s %-24s G%-3u S%-3u B%-3u T%u\n",
+                  (unsigned)row.rank,
+                  row.countryCode,
+                  row.countryName,
+                  (unsigned)row.gold,
+                  (unsigned)row.silver,
+                  (unsigned)row.bronze,
+                  (unsigned)row.total);
+  }
+  for (uint8_t f = 0; f < medals.favoriteCount; ++f) {
+    const FavoriteStanding &standing = medals.favorites[f];
+    const MedalRow &row = standing.row;
+    Serial.printf("  favourite %-3s %s G%u S%u B%u T%u\n",
+                  favorites.code(f),
+                  standing.present ? "in feed" : "absent",
+                  (unsigned)row.gold,
+                  (unsigned)row.silver,
+                  (unsigned)row.bronze,
+                  (unsigned)row.total);
+  }
+}
+
+static void printSchedule(const DailyScheduleState &schedule) {
+  for (uint8_t i = 0; i < schedule.rowCount; ++i) {
+    const CompetitionRow &row = schedule.rows[i];
+    Serial.printf("  %10ld %-9s %c %-6s %s\n",
+                  (long)row.startEpoch,
+                  statusName(row.status),
+                  row.isMedalSession ? 'M' : ' ',
+                  row.sportCode,
+                  row.title);
+  }
+}
+
+// Flag PNGs are served from this directory (`OLYMPICS_FLAG_SOURCE`, default
+// ./data/flags); anything else goes to the fixtures.
+static std::string flagSourceDir() {
+  return getenv("OLYMPICS_FLAG_SOURCE") ? getenv("OLYMPICS_FLAG_SOURCE") : "data/flags";
+}
+
+// A code with no flag anywhere, and how often its flag has been requested.
+static const char *kDeadFlagCode = "ZZZ";
+static std::atomic<uint32_t> g_deadFlagRequests{0};
+
+static std::shared_ptr<const NativeHttp::Response> serveFlags(const std::string &url) {
+  if (url == medalFlagUrl(kDeadFlagCode).c_str()) g_deadFlagRequests++;
+  auto flag = NativeHttp::pngResponse(url, flagSourceDir());
+  return flag ? flag : NativeHttp::fixtureResponse(url);
+}
+
+// A one-tile atlas partition, so the mapped-flash path is drawn from too.
+static const uint16_t kAtlasColor = 0x1234;
+
+static bool writeAtlas(const std::string &dir, const char *code, int16_t size) {
+  FlagAtlas::Header header = {FlagAtlas::kMagic, FlagAtlas::kVersion, 1, 0};
+  FlagAtlas::Entry entry = {};
+  strlcpy(entry.code, code, sizeof(entry.code));
+  entry.size = (uint16_t)size;
+  entry.w = (uint16_t)size;
+  entry.h = (uint16_t)size;
+  entry.offset = sizeof(header) + sizeof(entry);
+  header.totalBytes = entry.offset + (uint32_t)size * size * 2;
+  const std::vector<uint16_t> pixels((size_t)size * size, kAtlasColor);
+
+  std::filesystem::create_directories(dir);
+  FILE *f = fopen((dir + "/flags.bin").c_str(), "wb");
+  if (!f) return false;
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(&entry, sizeof(entry), 1, f);
+  fwrite(pixels.data(), sizeof(uint16_t), pixels.size(), f);
+  return fclose(f) == 0;
+}
+
+// Draws each code's flag at table size until the prefetcher has fetched every
+// flag it can, then twice more: once decoding from SPIFFS, once from the tile
+// cache. One code is served from the atlas and one has no source file, so
+// every path and the failed-download backoff are hit. Returns false if any
+// pass drew something other than expected, if the dead code was requested
+// again inside its backoff, or if there was no flag to fetch at all.
+static bool exerciseAssets(const MedalTableState &medals) {
+  static const char *kFallbackCodes[] = {"NOR", "GER", "USA", "CAN", "AUT", "SUI"};
+  static const int16_t kSize = 12;
+  std::vector<String> codes;
+  for (uint8_t i = 0; i < medals.rowCount && codes.size() < 8; ++i) codes.push_back(medals.rows[i].countryCode);
+  if (codes.empty()) codes.assign(std::begin(kFallbackCodes), std::end(kFallbackCodes));
+  codes.push_back(kDeadFlagCode);
+
+  std::filesystem::remove_all(NativeFs::root() + "/flags");
+  const std::string partitions = NativeFs::root() + "/partitions";
+  NativePartition::dir() = partitions;
+  const String atlasCode = codes.front();
+  if (!writeAtlas(partitions, atlasCode.c_str(), kSize)) return false;
+  NativeHttp::responder() = serveFlags;
+
+  uint32_t fetchable = 0;
+  for (size_t i = 1; i < codes.size(); ++i) {
+    if (std::filesystem::exists(flagSourceDir() + "/" + codes[i].c_str() + ".png")) fetchable++;
+  }
+  if (fetchable == 0) {
+    Serial.printf("assets: no flags to fetch in %s\n", flagSourceDir().c_str());
+    return false;
+  }
+
+  static TFT_eSPI tft;
+  tft.init();
+  tft.setRotation(1);
+  Assets::begin(tft);
+
+  auto drawAll = [&](uint32_t &drawn) {
+    drawn = 0;
+    for (size_t i = 0; i < codes.size(); ++i) {
+      const int16_t x = (int16_t)(4 + i * (kSize + 4));
+      if (Assets::drawLogo(tft, codes[i], medalFlagUrl(codes[i].c_str()), x, 40, kSize)) drawn++;
+    }
+  };
+
+  uint32_t firstPass = 0;
+  drawAll(firstPass);
+  const uint32_t start = millis();
+  while (Assets::flagGeneration() < fetchable && millis() - start < 10000) delay(10);
+  const uint32_t fetched = Assets::flagGeneration();
+  const uint32_t fetchMs = millis() - start;
+  // The dead code is queued last; wait for its failed download.
+  while (g_deadFlagRequests == 0 && millis() - start < 10000) delay(10);
+  const uint32_t deadRequests = g_deadFlagRequests;
+
+  const FlagTileCache::Stats before = Assets::flagCacheStats();
+  uint32_t decodePass = 0;
+  drawAll(decodePass);
+  const FlagTileCache::Stats decoded = Assets::flagCacheStats();
+  uint32_t cachedPass = 0;
+  drawAll(cachedPass);
+  const FlagTileCache::Stats cached = Assets::flagCacheStats();
+  const bool atlasDrawn = tft.readPixel(4 + kSize / 2, 40 + kSize / 2) == kAtlasColor;
+  // Both passes drew the dead code again; give a queued retry time to run.
+  delay(100);
+  const uint32_t retried = g_deadFlagRequests - deadRequests;
+
+  Serial.printf("assets: atlas %s %s\n", atlasCode.c_str(), atlasDrawn ? "drawn from flash" : "MISSING");
+  Serial.printf("assets: first pass %u/%u flags; prefetched %u/%u in %lu ms\n",
+                (unsigned)firstPass,
+                (unsigned)codes.size(),
+                (unsigned)fetched,
+                (unsigned)fetchable,
+                (unsigned long)fetchMs);
+  Serial.printf("assets: decode pass %u flags, %lu tile hits; cached pass %u flags, %lu tile hits\n",
+                (unsigned)decodePass,
+                (unsigned long)(decoded.hits - before.hits),
+                (unsigned)cachedPass,
+                (unsigned long)(cached.hits - decoded.hits));
+  Serial.printf("assets: %s failed %u time(s), %u request(s) inside its backoff\n",
+                codes.back().c_str(),
+                (unsigned)deadRequests,
+                (unsigned)retried);
+
+  const uint32_t expected = 1 + fetchable;
+  return atlasDrawn && firstPass == 1 && fetched == fetchable && decodePass == expected &&
+         cachedPass == expected && cached.hits - decoded.hits == fetchable && deadRequests == 1 && retried == 0;
+}
+
+}  // namespace
+
+// usage: olympics_native [YYYY-MM-DD] [anthem-ms]
+int main(int argc, char **argv) {
+  const String ymd = (argc > 1) ? String(argv[1]) : String("2026-02-10");
+  OlympicScoreboardClient client;
+  FavoriteSet favorites;
+  favorites.parse(FOCUS_TEAM_ABBRS);
+  client.loadSportBaseline(favorites);
+
+  MedalTableState medals;
+  const FetchResult medalsResult = client.fetchMedalTable(medals, favorites);
+  Serial.printf("medals: %s, %u rows\n", resultName(medalsResult), (unsigned)medals.rowCount);
+  printMedals(medals, favorites);
+
+  DailyScheduleState schedule;
+  const FetchResult scheduleResult = client.fetchDailySchedule(schedule, ymd);
+  Serial.printf("schedule %s: %s, %u rows\n", ymd.c_str(), resultName(scheduleResult), (unsigned)schedule.rowCount);
+  printSchedule(schedule);
+
+  // A second round exercises the conditional-request path.
+  MedalTableState again;
+  Serial.printf("medals again: %s\n", resultName(client.fetchMedalTable(again, favorites)));
+
+  if (medalsResult == FetchResult::OK) StateStore::saveMedals(medals, millis());
+  if (scheduleResult == FetchResult::OK) StateStore::saveSchedule(schedule, millis());
+  MedalTableState restored;
+  const bool roundTripOk = medalsResult == FetchResult::OK && StateStore::loadMedals(restored) &&
+                           restored.rowCount == medals.rowCount;
+  Serial.printf("state store round trip: %s\n", roundTripOk ? "ok" : "missing");
+
+  PollScheduler scheduler;
+  scheduler.update(schedule, time(nullptr), ymd);
+
+  const bool assetsOk = exerciseAssets(medals);
+  Serial.printf("assets: %s\n", assetsOk ? "ok" : "FAILED");
+
+  if (argc > 2) {
+    Anthem::begin();
+    Anthem::playNowForMs((uint32_t)atol(argv[2]));
+  }
+  const bool feedsOk = medalsResult != FetchResult::FAILED && scheduleResult != FetchResult::FAILED;
+  return feedsOk && roundTripOk && assetsOk ? 0 : 1;
+}
+
+#endif  // NATIVE_BUILD
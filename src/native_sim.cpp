@@ -0,0 +1,406 @@
+// Games replay for the `native_sim` env: runs the real setup()/loop() and
+// network task from main.cpp on a virtual clock against a synthetic Winter
+// Games, then reports requests, bytes, alert latency and missed or spurious
+// alerts, plus heap churn and growth. The display and Wi-Fi are replaced by recorders below; the asset
+// layer is the real one, fetching flags from data/flags (`OLYMPICS_FLAG_SOURCE`)
+// into a scratch SPIFFS and drawing them into the framebuffer panel.
+#ifdef NATIVE_SIM
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <SPIFFS.h>
+#include <TFT_eSPI.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <map>
+#include <vector>
+
+#include "assets.h"
+#include "config.h"
+#include "olympic_scoreboard_ui.h"
+#include "sim/coop_scheduler.h"
+#include "sim/games_timeline.h"
+#include "wifi_fallback.h"
+
+void setup();
+void loop();
+
+namespace {
+
+// 2026-02-06 00:00 CET, the first full day of Milano Cortina.
+static const time_t kGamesStartEpoch = 1770332400;
+static const uint32_t kLoopDelayUs = 20 * 1000;
+// Awards released this close to the end may legitimately not be alerted yet.
+static const time_t kMissedGraceSec = 3600;
+
+struct ShownAlert {
+  time_t epoch;
+  MedalAlertEvent alert;
+};
+
+struct EndpointStats {
+  uint32_t requests = 0;
+  uint32_t notModified = 0;
+  uint32_t errors = 0;
+  uint64_t bytes = 0;
+};
+
+std::vector<ShownAlert> g_alerts;
+std::map<std::string, EndpointStats> g_endpoints;
+uint32_t g_renders = 0;
+uint32_t g_flagDraws = 0;
+// Every task shares the one host thread, so plain counters are safe. Live
+// bytes cover everything; the allocation count leaves out the synthetic feed
+// generator, which has no counterpart on the board.
+bool g_countAllocs = true;
+uint64_t g_allocs = 0;
+size_t g_liveBytes = 0;
+size_t g_liveBlocks = 0;
+size_t g_peakBytes = 0;
+uint32_t g_badgeDraws = 0;
+uint64_t g_httpBusyUs = 0;
+
+static time_t virtualEpoch() { return kGamesStartEpoch + (time_t)(NativeClock::nowUs() / 1000000ULL); }
+
+static const char *endpointFor(const std::string &url) {
+  if (url.find("/medals/country") != std::string::npos) return "medals-country";
+  if (url.find("/medals/sport") != std::string::npos) return "medals-sport";
+  if (url.find("/schedule") != std::string::npos) return "schedule";
+  if (url.find("/country-flags/") != std::string::npos) return "flags";
+  return "other";
+}
+
+// Any flag in `dir` answers for countries without a file there, so flag
+// traffic looks like the CDN's, which has every country. Empty if none.
+static std::string standInFlag(const std::string &dir) {
+  std::string found;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return found;
+  while (struct dirent *e = readdir(d)) {
+    const std::string name = e->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".png") == 0) {
+      found = dir + "/" + name;
+      break;
+    }
+  }
+  closedir(d);
+  return found;
+}
+
+static std::string queryParam(const std::string &url, const char *name) {
+  const std::string key = std::string(name) + "=";
+  size_t pos = url.find(key);
+  if (pos == std::string::npos) return std::string();
+  pos += key.size();
+  return url.substr(pos, url.find('&', pos) - pos);
+}
+
+struct UncountedAllocs {
+  UncountedAllocs() { g_countAllocs = false; }
+  ~UncountedAllocs() { g_countAllocs = true; }
+};
+
+static uint32_t percentile(std::vector<uint32_t> values, uint8_t pct) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) * pct / 100];
+}
+
+}  // namespace
+
+#if defined(__GLIBC__)
+// Interpose the C allocator, as native_bench does, so every firmware
+// allocation over the replay is counted and live bytes can be followed.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+static void trackAlloc(void *ptr) {
+  if (!ptr) return;
+  if (g_countAllocs) g_allocs++;
+  g_liveBlocks++;
+  g_liveBytes += malloc_usable_size(ptr);
+  if (g_liveBytes > g_peakBytes) g_peakBytes = g_liveBytes;
+}
+
+static void trackFree(void *ptr) {
+  if (!ptr) return;
+  g_liveBlocks--;
+  g_liveBytes -= malloc_usable_size(ptr);
+}
+
+void *malloc(size_t size) {
+  void *ptr = __libc_malloc(size);
+  trackAlloc(ptr);
+  return ptr;
+}
+
+void *calloc(size_t n, size_t size) {
+  void *ptr = __libc_calloc(n, size);
+  trackAlloc(ptr);
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  trackFree(ptr);
+  void *out = __libc_realloc(ptr, size);
+  trackAlloc(out ? out : ptr);
+  return out;
+}
+
+void free(void *ptr) {
+  trackFree(ptr);
+  __libc_free(ptr);
+}
+}
+#endif
+
+// The firmware reads wall time through time(); serve the virtual clock.
+extern "C" time_t time(time_t *out) {
+  const time_t now = virtualEpoch();
+  if (out) *out = now;
+  return now;
+}
+
+// --- Recorders standing in for the display and Wi-Fi. ---
+
+void OlympicScoreboardUi::begin(TFT_eSPI &tft, uint8_t rotation) {
+  _tft = &tft;
+  setRotation(rotation);
+}
+
+void OlympicScoreboardUi::setRotation(uint8_t rotation) {
+  _rotation = rotation;
+  _tft->setRotation(rotation);
+}
+
+void OlympicScoreboardUi::setBacklight(uint8_t) {}
+void OlympicScoreboardUi::drawBootSplash(const String &, const String &) { g_renders++; }
+// Draws each row's flag as the table would, so the tile cache sees real traffic.
+void OlympicScoreboardUi::drawMedals(const MedalTableState &medals, const FavoriteSet &, bool, bool) {
+  g_renders++;
+  for (uint8_t i = 0; i < medals.rowCount; ++i) {
+    const char *code = medals.rows[i].countryCode;
+    if (Assets::drawLogo(*_tft, code, medalFlagUrl(code), 4, (int16_t)(40 + i * kTableFlagSize), kTableFlagSize)) {
+      g_flagDraws++;
+    } else {
+      g_badgeDraws++;
+    }
+  }
+}
+void OlympicScoreboardUi::drawSchedule(const DailyScheduleState &, bool, bool) { g_renders++; }
+
+void OlympicScoreboardUi::drawMedalAlert(const MedalAlertEvent &alert) {
+  g_renders++;
+  g_alerts.push_back({time(nullptr), alert});
+}
+
+bool wifiConnectWithFallback() { return true; }
+void wifiTick() {}
+
+// usage: native_sim [days] [seed] [-v]
+int main(int argc, char **argv) {
+  uint8_t days = 16;
+  uint32_t seed = 2026;
+  bool verbose = false;
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-v")) {
+      verbose = true;
+    } else if (positional++ == 0) {
+      days = (uint8_t)atoi(argv[i]);
+    } else {
+      seed = (uint32_t)strtoul(argv[i], nullptr, 10);
+    }
+  }
+
+  static CoopScheduler scheduler;
+  NativeClock::scheduler() = &scheduler;
+
+  char fsRoot[] = "/tmp/olympics_sim_XXXXXX";
+  if (!mkdtemp(fsRoot)) return 1;
+  NativeFs::root() = fsRoot;
+
+  setenv("TZ", TZ_INFO, 1);
+  tzset();
+  static GamesTimeline games(FOCUS_TEAM_ABBRS, kGamesStartEpoch, days, seed);
+  static const std::string flagDir = getenv("OLYMPICS_FLAG_SOURCE") ? getenv("OLYMPICS_FLAG_SOURCE") : "data/flags";
+  static const std::string standIn = standInFlag(flagDir);
+  if (standIn.empty()) printf("no flags in %s; every flag request will fail\n", flagDir.c_str());
+
+  NativeHttp::responder() = [](const std::string &url) -> std::shared_ptr<const NativeHttp::Response> {
+    const UncountedAllocs uncounted;
+    const time_t now = time(nullptr);
+    const std::string endpoint = endpointFor(url);
+    std::string body;
+    if (endpoint == "medals-country") {
+      body = games.medalsCountryJson(now);
+    } else if (endpoint == "medals-sport") {
+      body = games.medalsSportJson(queryParam(url, "sportCode"), now);
+    } else if (endpoint == "schedule") {
+      body = games.scheduleJson(queryParam(url, "startDate"), now);
+    } else if (endpoint == "flags") {
+      auto png = NativeHttp::pngResponse(url, flagDir);
+      return png || standIn.empty() ? png : NativeHttp::fileResponse(standIn);
+    }
+    return body.empty() ? nullptr : NativeHttp::makeResponse(std::move(body));
+  };
+  NativeHttp::observer() = [](const std::string &url, int code, size_t bytes) {
+    const UncountedAllocs uncounted;
+    const NativeHttp::Link &link = NativeHttp::link();
+    g_httpBusyUs += (uint64_t)link.roundTripMs * 1000ULL + (uint64_t)bytes * 1000000ULL / link.bytesPerSec;
+    EndpointStats &stats = g_endpoints[endpointFor(url)];
+    stats.requests++;
+    stats.bytes += bytes;
+    if (code == 304) stats.notModified++;
+    if (code != 200 && code != 304) stats.errors++;
+  };
+  // A middling home connection to a busy CDN.
+  NativeHttp::link().roundTripMs = 350;
+  NativeHttp::link().bytesPerSec = 200 * 1024;
+
+  HardwareSerial::nativeMuted() = !verbose;
+  setup();
+
+  const uint64_t endUs = (uint64_t)(games.endEpoch() - kGamesStartEpoch) * 1000000ULL;
+  uint64_t loopBusyUs = 0;
+  uint32_t loopBusyMaxUs = 0;
+  uint32_t loops = 0;
+  // Heap after the first hour, once caches and tasks are warm.
+  static const uint64_t kWarmUs = 3600ULL * 1000000ULL;
+  bool warm = false;
+  uint64_t warmAllocs = 0;
+  size_t warmBytes = 0;
+  size_t warmBlocks = 0;
+  while (NativeClock::nowUs() < endUs) {
+    const uint64_t startUs = NativeClock::nowUs();
+    loop();
+    const uint64_t tookUs = NativeClock::nowUs() - startUs;
+    const uint32_t busyUs = tookUs > kLoopDelayUs ? (uint32_t)(tookUs - kLoopDelayUs) : 0;
+    loopBusyUs += busyUs;
+    loopBusyMaxUs = max(loopBusyMaxUs, busyUs);
+    loops++;
+    if (!warm && NativeClock::nowUs() >= kWarmUs) {
+      warm = true;
+      warmAllocs = g_allocs;
+      warmBytes = g_liveBytes;
+      warmBlocks = g_liveBlocks;
+    }
+  }
+  HardwareSerial::nativeMuted() = false;
+
+  // Match each alert, oldest first, to the earliest unclaimed favourite medals
+  // of the same colour already in the feed.
+  std::vector<const GamesTimeline::Award *> truth;
+  for (const GamesTimeline::Award &a : games.awards()) {
+    if (games.isFavorite(a) && a.feedEpoch < games.endEpoch()) truth.push_back(&a);
+  }
+  std::vector<bool> claimed(truth.size(), false);
+  std::vector<uint32_t> latencies;
+  uint32_t spurious = 0;
+  uint32_t sportCorrect = 0;
+  for (const ShownAlert &shown : g_alerts) {
+    for (uint8_t n = 0; n < max<uint8_t>(shown.alert.delta, 1); ++n) {
+      bool matched = false;
+      for (size_t i = 0; i < truth.size(); ++i) {
+        if (claimed[i] || truth[i]->medal != (uint8_t)shown.alert.medalType) continue;
+        if (games.countryCode(truth[i]->country) != shown.alert.countryCode) continue;
+        if (truth[i]->feedEpoch > shown.epoch) break;
+        claimed[i] = true;
+        matched = true;
+        latencies.push_back((uint32_t)(shown.epoch - truth[i]->feedEpoch));
+        if (!strcmp(GamesTimeline::sports()[truth[i]->sport].code, shown.alert.sportCode)) sportCorrect++;
+        break;
+      }
+      if (!matched) spurious++;
+    }
+  }
+  uint32_t missed = 0;
+  for (size_t i = 0; i < truth.size(); ++i) {
+    if (!claimed[i] && truth[i]->feedEpoch < games.endEpoch() - kMissedGraceSec) missed++;
+  }
+
+  printf("Replayed %u days (seed %u), favourites %s, %s polling\n",
+         (unsigned)days,
+         (unsigned)seed,
+         FOCUS_TEAM_ABBRS,
+         ADAPTIVE_POLLING ? "adaptive" : "fixed 30s/60s");
+  printf("\n%-16s %9s %9s %7s %12s\n", "endpoint", "requests", "304s", "errors", "bytes");
+  uint32_t totalRequests = 0;
+  uint64_t totalBytes = 0;
+  uint32_t feedRequests = 0;
+  for (const auto &entry : g_endpoints) {
+    const EndpointStats &s = entry.second;
+    printf("%-16s %9u %9u %7u %12llu\n",
+           entry.first.c_str(),
+           (unsigned)s.requests,
+           (unsigned)s.notModified,
+           (unsigned)s.errors,
+           (unsigned long long)s.bytes);
+    totalRequests += s.requests;
+    totalBytes += s.bytes;
+    if (entry.first != "flags") feedRequests += s.requests;
+  }
+  printf("%-16s %9u %9s %7s %12llu  (%.1f req/h)\n",
+         "total",
+         (unsigned)totalRequests,
+         "",
+         "",
+         (unsigned long long)totalBytes,
+         totalRequests * 3600.0 / (days * 86400.0));
+  // Flags are fetched once per country and depend on the asset set, not the
+  // planner; compare policies on the feeds alone.
+  printf("%-16s %9u %9s %7s %12s  (%.1f req/h)\n",
+         "feeds",
+         (unsigned)feedRequests,
+         "",
+         "",
+         "",
+         feedRequests * 3600.0 / (days * 86400.0));
+
+  printf("\nfavourite medals in feed: %u, alerts shown: %u\n", (unsigned)truth.size(), (unsigned)g_alerts.size());
+  printf("alerted: %u, missed: %u, spurious/duplicate: %u, sport attributed correctly: %u\n",
+         (unsigned)latencies.size(),
+         (unsigned)missed,
+         (unsigned)spurious,
+         (unsigned)sportCorrect);
+  printf("alert latency feed->screen s: p50 %u, p95 %u, max %u\n",
+         (unsigned)percentile(latencies, 50),
+         (unsigned)percentile(latencies, 95),
+         (unsigned)percentile(latencies, 100));
+  printf("\nnetwork task in HTTP: %.1f h of %.1f h; UI loop blocked: %.1f s total, %.1f ms worst (%u loops, %u renders)\n",
+         g_httpBusyUs / 3.6e9,
+         days * 24.0,
+         loopBusyUs / 1e6,
+         loopBusyMaxUs / 1e3,
+         (unsigned)loops,
+         (unsigned)g_renders);
+  const double warmHours = days * 24.0 - 1.0;
+  printf("heap after the first hour: %.0f allocs/h; live %lu B in %lu blocks -> %lu B in %lu blocks at end (peak %lu B)\n",
+         warm && warmHours > 0 ? (g_allocs - warmAllocs) / warmHours : 0.0,
+         (unsigned long)warmBytes,
+         (unsigned long)warmBlocks,
+         (unsigned long)g_liveBytes,
+         (unsigned long)g_liveBlocks,
+         (unsigned long)g_peakBytes);
+  const FlagTileCache::Stats flags = Assets::flagCacheStats();
+  printf("table flags: %u drawn, %u badges; flags fetched %u; tile cache %lu hits, %lu misses, %u tiles\n",
+         (unsigned)g_flagDraws,
+         (unsigned)g_badgeDraws,
+         (unsigned)Assets::flagGeneration(),
+         (unsigned long)flags.hits,
+         (unsigned long)flags.misses,
+         (unsigned)flags.tiles);
+  fflush(stdout);
+  // The network task never returns; leave without unwinding it.
+  _exit(0);
+}
+
+#endif  // NATIVE_SIM
@@ -1,7 +1,14 @@
 #include "olympic_scoreboard_client.h"
 
+#include <ArduinoJson.h>
 #include <HTTPClient.h>
+#include <Preferences.h>
 #include <WiFiClientSecure.h>
+#include <rom/crc.h>
+
+#include "chunked_stream.h"
+#include "inflate_stream.h"
+#include "json_sax.h"
 
 namespace {
 
@@ -11,87 +18,353 @@ static const char *kMedalsSportUrlPrefix =
   "https://sdf.nbcolympics.com/v1/widget/medals/sport?competitionCode=OWG2026&sportCode=";
 static const char *kScheduleUrlPrefix =
   "https://schedules.nbcolympics.com/api/v1/schedule?startDate=";
+static const char *kCompetitionCode = "OWG2026";
+static const char *kFlagUrlPrefix = "https://images.nbcolympics.com/country-flags/38x25/";
 static const char *kMedalsApiHeaderValue = "daaacddd-1513-46a3-8b79-ac3584258f5b";
 
-class ChunkedStream : public Stream {
+// Keep-alive sockets idle longer than this are closed before reuse rather than
+// risking a request on a connection the server has already dropped.
+static const uint32_t kKeepAliveIdleMs = 60000;
+static const uint16_t kHttpTimeoutMs = 12000;
+// When a parser stops early, up to this much unread body is drained to keep
+// the socket; a bigger tail costs more airtime than a fresh TLS handshake.
+static const size_t kMaxDrainBytes = 8 * 1024;
+// gzip is only offered if the inflater fits with this much contiguous heap to
+// spare for mbedTLS's 16 KB record buffers on a reconnect; otherwise the body
+// comes uncompressed.
+static const size_t kInflateHeadroomBytes = 20 * 1024;
+// Replaces HTTPClient's own identity-only Accept-Encoding when gzip is offered.
+static const char *kAcceptEncodingGzip = "gzip, deflate, identity;q=0.5";
+
+// Per-endpoint backoff: 10s doubling to 5 min, jittered to 50-100% so a fleet
+// of boards that failed together does not retry together.
+static const uint32_t kBackoffBaseMs = 10000;
+static const uint32_t kBackoffMaxMs = 5UL * 60UL * 1000UL;
+static const uint8_t kBreakerOpenFailures = 3;
+static const char *kEndpointNames[] = {"medals", "sport", "schedule"};
+
+// Medal sessions that started within this window (or are live) are treated as
+// likely sources of a fresh medal when attributing it to a sport.
+static const time_t kAttributionWindowSec = 4 * 3600;
+static const uint8_t kMaxCandidateSports = 3;
+
+static const char *kPrefsNamespace = "olympics";
+static const char *kPrefsSportBaselineKey = "sportBase";
+static const uint16_t kSportBaselineVersion = 1;
+
+// HTTPClient always sends an Accept-Encoding of its own; cores that let it be
+// replaced have setAcceptEncoding(). On older cores a second header would
+// only be merged with the built-in "*;q=0", so gzip is not offered there.
+template <typename Client>
+auto replaceAcceptEncoding(Client &http, const char *value, int)
+  -> decltype(http.setAcceptEncoding(String(value)), bool()) {
+  http.setAcceptEncoding(String(value));
+  return true;
+}
+
+template <typename Client>
+bool replaceAcceptEncoding(Client &, const char *, long) {
+  return false;
+}
+
+// Wraps the body stream and folds every byte the parser consumes into a
+// FNV-1a hash, so identical payloads can be recognised after the fact.
+class HashingStream : public Stream {
 public:
-  explicit ChunkedStream(Stream &src) : _src(src) {}
-
-  int available() override {
-    if (_done) return 0;
-    if (_peeked >= 0) return 1;
-    if (_remaining > 0) {
-      int avail = _src.available();
-      if (avail > _remaining) avail = _remaining;
-      return avail;
-    }
-    return _src.available();
-  }
+  explicit HashingStream(Stream &src) : _src(src) {}
 
-  int read() override {
-    if (_peeked >= 0) {
-      const int c = _peeked;
-      _peeked = -1;
-      return c;
-    }
-    if (_done) return -1;
-    if (_remaining == 0 && !readChunkHeader()) return -1;
+  int available() override { return _src.available(); }
 
+  int read() override {
     const int c = _src.read();
-    if (c < 0) return -1;
-    _remaining--;
-    if (_remaining == 0) consumeCrlf();
+    if (c >= 0) {
+      _hash ^= (uint8_t)c;
+      _hash *= 16777619u;
+      _count++;
+    }
     return c;
   }
 
-  int peek() override {
-    if (_peeked < 0) _peeked = read();
-    return _peeked;
+  // Parsers pull through readBytes(); forwarding it keeps the inner stream's
+  // bulk path instead of falling back to Stream's per-byte timedRead().
+  size_t readBytes(char *buffer, size_t length) override {
+    const size_t n = _src.readBytes(buffer, length);
+    for (size_t i = 0; i < n; ++i) {
+      _hash ^= (uint8_t)buffer[i];
+      _hash *= 16777619u;
+    }
+    _count += n;
+    return n;
   }
 
+  int peek() override { return _src.peek(); }
   void flush() override {}
   size_t write(uint8_t) override { return 0; }
 
+  uint32_t hash() const { return _hash; }
+  size_t count() const { return _count; }
+
 private:
   Stream &_src;
-  int _peeked = -1;
-  int _remaining = 0;
-  bool _done = false;
-
-  bool readChunkHeader() {
-    char line[24];
-    size_t n = _src.readBytesUntil('\n', line, sizeof(line) - 1);
-    if (n == 0) return false;
-    line[n] = '\0';
-    if (n && line[n - 1] == '\r') line[n - 1] = '\0';
-    char *semi = strchr(line, ';');
-    if (semi) *semi = '\0';
-    _remaining = (int)strtol(line, nullptr, 16);
-    if (_remaining == 0) {
-      _done = true;
-      return false;
-    }
-    return true;
+  uint32_t _hash = 2166136261u;
+  size_t _count = 0;
+};
+
+// Reads and discards `n` body bytes; returns how many were actually skipped.
+static size_t skipBody(Stream &stream, size_t n) {
+  uint8_t buf[256];
+  size_t done = 0;
+  while (done < n) {
+    const size_t want = (n - done < sizeof(buf)) ? n - done : sizeof(buf);
+    const size_t got = stream.readBytes(buf, want);
+    if (got == 0) break;
+    done += got;
   }
+  return done;
+}
+
+static uint32_t hashString(const String &s) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < s.length(); ++i) {
+    h ^= (uint8_t)s[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// Continues an FNV-1a hash over a C string.
+static uint32_t hashText(uint32_t h, const char *s) {
+  for (; *s; ++s) {
+    h ^= (uint8_t)*s;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// Copies into a fixed buffer, trimming blanks and upper-casing; longer input
+// is truncated to fit.
+static void copyUpper(char *dst, size_t cap, const char *src) {
+  while (*src == ' ') src++;
+  size_t n = 0;
+  while (*src && n + 1 < cap) dst[n++] = (char)toupper((unsigned char)*src++);
+  while (n > 0 && dst[n - 1] == ' ') n--;
+  dst[n] = '\0';
+}
 
-  void consumeCrlf() {
-    (void)_src.read();
-    (void)_src.read();
+static EventStatus parseEventStatus(const char *text) {
+  if (!strcasecmp(text, "live") || !strcasecmp(text, "in progress")) return EventStatus::LIVE;
+  if (!strcasecmp(text, "final") || !strcasecmp(text, "finished") || !strcasecmp(text, "complete") ||
+      !strcasecmp(text, "completed") || !strcasecmp(text, "official")) {
+    return EventStatus::FINAL;
   }
+  if (!strcasecmp(text, "upcoming") || !strcasecmp(text, "scheduled") || !strcasecmp(text, "pre")) {
+    return EventStatus::SCHEDULED;
+  }
+  return EventStatus::UNKNOWN;
+}
+
+class JsonDocumentParser : public ResponseParser {
+public:
+  JsonDocumentParser(JsonDocument &doc, const JsonDocument &filter) : _doc(doc), _filter(filter) {}
+
+  bool parse(Stream &body) override {
+    const DeserializationError err = deserializeJson(_doc,
+                                                     body,
+                                                     DeserializationOption::Filter(_filter),
+                                                     DeserializationOption::NestingLimit(24));
+    if (err) Serial.printf("JSON parse error: %s\n", err.c_str());
+    return !err;
+  }
+
+private:
+  JsonDocument &_doc;
+  const JsonDocument &_filter;
+};
+
+class SaxResponseParser : public ResponseParser {
+public:
+  explicit SaxResponseParser(JsonSaxHandler &handler) : _handler(handler) {}
+
+  bool parse(Stream &body) override {
+    JsonSaxParser parser(body, _handler);
+    const bool ok = parser.parse();
+    _stoppedEarly = parser.stoppedEarly();
+    if (!ok) Serial.printf("JSON parse error after %u bytes\n", (unsigned)parser.bytesRead());
+    return ok;
+  }
+
+  bool stoppedEarly() const override { return _stoppedEarly; }
+
+private:
+  JsonSaxHandler &_handler;
+  bool _stoppedEarly = false;
 };
 
-static String asUpper(const String &s) {
-  String out = s;
-  out.trim();
-  out.toUpperCase();
-  return out;
+static bool isRowLevel(const JsonSaxParser &p) {
+  return p.depth() == 2 && p.isArray(0) && !p.isArray(1);
+}
+
+// Both medal handlers read the top-level array and its row objects only;
+// whatever a row nests (links, images, ...) is skipped.
+static bool wantsRowLevel(const JsonSaxParser &p) {
+  return p.depth() < 2;
 }
 
+// Fills MedalTableState straight from the medals-by-country array. Rows past
+// kMaxMedalRows are scanned only until every favourite's line is known.
+class MedalTableHandler : public JsonSaxHandler {
+public:
+  MedalTableHandler(MedalTableState &out, const FavoriteSet &favorites) : _out(out), _favs(favorites) {}
+
+  bool sawArray() const { return _sawArray; }
+
+  bool wantsContainer(const JsonSaxParser &p, bool) override { return wantsRowLevel(p); }
+
+  void onContainerStart(const JsonSaxParser &p) override {
+    if (p.depth() == 1 && p.isArray(0)) _sawArray = true;
+    if (!isRowLevel(p)) return;
+    _row = (_out.rowCount < kMaxMedalRows) ? &_out.rows[_out.rowCount] : &_overflow;
+    *_row = MedalRow();
+  }
+
+  void onValue(const JsonSaxParser &p, JsonSaxType type, const char *text) override {
+    if (!_row) return;
+    const bool isText = (type == JsonSaxType::STRING);
+    if (p.depth() == 2) {
+      if (p.keyIs(1, "countryCode")) {
+        if (isText) copyUpper(_row->countryCode, sizeof(_row->countryCode), text);
+      } else if (p.keyIs(1, "countryName")) {
+        if (isText) strlcpy(_row->countryName, text, sizeof(_row->countryName));
+      } else if (p.keyIs(1, "gold")) {
+        _row->gold = (uint16_t)atoi(text);
+      } else if (p.keyIs(1, "silver")) {
+        _row->silver = (uint16_t)atoi(text);
+      } else if (p.keyIs(1, "bronze")) {
+        _row->bronze = (uint16_t)atoi(text);
+      } else if (p.keyIs(1, "medalTotal")) {
+        _row->total = (uint16_t)atoi(text);
+      } else if (p.keyIs(1, "medalRank")) {
+        _row->rank = (uint16_t)atoi(text);
+      }
+    }
+  }
+
+  void onContainerEnd(const JsonSaxParser &p) override {
+    if (!_row || !isRowLevel(p)) return;
+    const bool stored = (_row != &_overflow);
+    const int8_t fav = _favs.indexOf(packNoc(_row->countryCode));
+    if (fav >= 0 && !_out.favorites[fav].present) {
+      FavoriteStanding &standing = _out.favorites[fav];
+      standing.present = true;
+      standing.index = stored ? (int8_t)_out.rowCount : -1;
+      standing.row = *_row;
+      _favoritesFound++;
+    }
+    if (stored) _out.rowCount++;
+    _row = nullptr;
+  }
+
+  bool done() const override { return _out.rowCount >= kMaxMedalRows && _favoritesFound >= _favs.count(); }
+
+private:
+  MedalTableState &_out;
+  const FavoriteSet &_favs;
+  uint8_t _favoritesFound = 0;
+  MedalRow _overflow;
+  MedalRow *_row = nullptr;
+  bool _sawArray = false;
+};
+
+// Scans the medals-by-sport array for the favourites and stops once all are
+// found. Counts are indexed by favourite, then MedalType.
+class SportCountsHandler : public JsonSaxHandler {
+public:
+  SportCountsHandler(const FavoriteSet &favorites, uint16_t (&counts)[kMaxFavorites][3])
+    : _favs(favorites), _counts(counts) {}
+
+  bool sawArray() const { return _sawArray; }
+
+  bool wantsContainer(const JsonSaxParser &p, bool) override { return wantsRowLevel(p); }
+
+  void onContainerStart(const JsonSaxParser &p) override {
+    if (p.depth() == 1 && p.isArray(0)) _sawArray = true;
+    if (!isRowLevel(p)) return;
+    _fav = -1;
+    _rowGold = _rowSilver = _rowBronze = 0;
+  }
+
+  void onValue(const JsonSaxParser &p, JsonSaxType type, const char *text) override {
+    if (!isRowLevel(p)) return;
+    if (p.keyIs(1, "countryCode")) {
+      char code[8];
+      copyUpper(code, sizeof(code), text);
+      _fav = (type == JsonSaxType::STRING && strlen(code) == kNocCodeLen) ? _favs.indexOf(packNoc(code)) : -1;
+    } else if (p.keyIs(1, "gold")) {
+      _rowGold = (uint16_t)atoi(text);
+    } else if (p.keyIs(1, "silver")) {
+      _rowSilver = (uint16_t)atoi(text);
+    } else if (p.keyIs(1, "bronze")) {
+      _rowBronze = (uint16_t)atoi(text);
+    }
+  }
+
+  void onContainerEnd(const JsonSaxParser &p) override {
+    if (!isRowLevel(p) || _fav < 0 || (_foundMask & (1U << _fav))) return;
+    _counts[_fav][(uint8_t)MedalType::GOLD] = _rowGold;
+    _counts[_fav][(uint8_t)MedalType::SILVER] = _rowSilver;
+    _counts[_fav][(uint8_t)MedalType::BRONZE] = _rowBronze;
+    _foundMask |= 1U << _fav;
+    _found++;
+  }
+
+  bool done() const override { return _found >= _favs.count(); }
+
+private:
+  const FavoriteSet &_favs;
+  uint16_t (&_counts)[kMaxFavorites][3];
+  int8_t _fav = -1;
+  uint16_t _rowGold = 0;
+  uint16_t _rowSilver = 0;
+  uint16_t _rowBronze = 0;
+  uint8_t _foundMask = 0;
+  uint8_t _found = 0;
+  bool _sawArray = false;
+};
+
 struct WinterSportDef {
   const char *code;
   const char *name;
 };
 
+// One long-lived TLS socket per API host, reused across polls via HTTP/1.1
+// keep-alive so only the first request after an idle period pays a handshake.
+struct PooledHost {
+  const char *host;
+  WiFiClientSecure tls;
+  uint32_t lastUsedMs;
+};
+
+static PooledHost g_pool[] = {
+  {"sdf.nbcolympics.com", {}, 0},
+  {"schedules.nbcolympics.com", {}, 0},
+};
+
+static PooledHost *pooledHostFor(const String &url) {
+  int start = url.indexOf("://");
+  start = (start < 0) ? 0 : start + 3;
+  int end = start;
+  while (end < (int)url.length() && url[end] != '/' && url[end] != ':' && url[end] != '?') {
+    end++;
+  }
+  const size_t hostLen = (size_t)(end - start);
+  for (PooledHost &entry : g_pool) {
+    if (strlen(entry.host) == hostLen && strncmp(url.c_str() + start, entry.host, hostLen) == 0) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 static const WinterSportDef kWinterSports[kWinterSportCount] = {
@@ -113,131 +386,410 @@ static const WinterSportDef kWinterSports[kWinterSportCount] = {
   {"STK", "Short Track"},
 };
 
-bool OlympicScoreboardClient::httpGetJson(const String &url,
-                                          JsonDocument &doc,
-                                          const JsonDocument *filter,
-                                          bool useMedalsAuth) {
-  WiFiClientSecure client;
+String medalFlagUrl(const char *countryCode) {
+  char lower[kNocCodeLen + 1];
+  size_t n = 0;
+  while (countryCode[n] && n < kNocCodeLen) {
+    lower[n] = (char)tolower((unsigned char)countryCode[n]);
+    n++;
+  }
+  lower[n] = '\0';
+  return String(kFlagUrlPrefix) + lower + ".png";
+}
+
+bool OlympicScoreboardClient::endpointAllowed(Endpoint endpoint) {
+  EndpointHealth &health = _health[(uint8_t)endpoint];
+  if (health.failures == 0) return true;
+  if ((int32_t)(millis() - health.retryAtMs) < 0) return false;
+  if (health.state == BreakerState::OPEN) {
+    health.state = BreakerState::HALF_OPEN;
+    Serial.printf("HTTP: %s breaker half-open, probing\n", kEndpointNames[(uint8_t)endpoint]);
+  }
+  return true;
+}
+
+void OlympicScoreboardClient::recordEndpointSuccess(Endpoint endpoint) {
+  EndpointHealth &health = _health[(uint8_t)endpoint];
+  if (health.state != BreakerState::CLOSED) {
+    Serial.printf("HTTP: %s breaker closed\n", kEndpointNames[(uint8_t)endpoint]);
+  }
+  health = EndpointHealth();
+}
+
+void OlympicScoreboardClient::recordEndpointFailure(Endpoint endpoint, uint32_t retryAfterMs) {
+  EndpointHealth &health = _health[(uint8_t)endpoint];
+  if (health.failures < 255) health.failures++;
+
+  const uint8_t shift = (health.failures > 8) ? 8 : (uint8_t)(health.failures - 1);
+  uint32_t backoffMs = kBackoffBaseMs << shift;
+  if (backoffMs > kBackoffMaxMs) backoffMs = kBackoffMaxMs;
+  backoffMs = backoffMs / 2 + esp_random() % (backoffMs / 2 + 1);
+  if (retryAfterMs > backoffMs) backoffMs = retryAfterMs;
+  health.retryAtMs = millis() + backoffMs;
+
+  if (health.state == BreakerState::HALF_OPEN || health.failures >= kBreakerOpenFailures) {
+    health.state = BreakerState::OPEN;
+    Serial.printf("HTTP: %s breaker open after %u failures, retry in %lus\n",
+                  kEndpointNames[(uint8_t)endpoint],
+                  (unsigned)health.failures,
+                  (unsigned long)(backoffMs / 1000));
+  }
+}
+
+OlympicScoreboardClient::CachedValidators *OlympicScoreboardClient::validatorsFor(uint32_t urlHash,
+                                                                                 bool create) {
+  CachedValidators *oldest = &_validators[0];
+  for (CachedValidators &entry : _validators) {
+    if (entry.urlHash == urlHash) return &entry;
+    // Empty slots go first, whatever the timestamps of the live ones.
+    if (oldest->urlHash != 0 && (entry.urlHash == 0 || entry.lastUsedMs < oldest->lastUsedMs)) {
+      oldest = &entry;
+    }
+  }
+  if (!create) return nullptr;
+  *oldest = CachedValidators();
+  oldest->urlHash = urlHash;
+  return oldest;
+}
+
+void OlympicScoreboardClient::forgetValidators(const String &url) {
+  CachedValidators *cached = validatorsFor(hashString(url), false);
+  if (cached) *cached = CachedValidators();
+}
+
+FetchResult OlympicScoreboardClient::httpGet(Endpoint endpoint,
+                                             const String &url,
+                                             ResponseParser &parser,
+                                             bool useMedalsAuth,
+                                             bool conditional) {
+  _lastHttpCode = 0;
+  if (!endpointAllowed(endpoint)) return FetchResult::FAILED;
+
+  CachedValidators *cached = conditional ? validatorsFor(hashString(url), true) : nullptr;
+  if (cached) cached->lastUsedMs = millis();
+
+  PooledHost *pooled = pooledHostFor(url);
+  WiFiClientSecure oneShot;
+  WiFiClientSecure &client = pooled ? pooled->tls : oneShot;
+  if (pooled && client.connected() && millis() - pooled->lastUsedMs > kKeepAliveIdleMs) {
+    client.stop();
+  }
   client.setInsecure();
-  client.setTimeout(12000);
+  client.setTimeout(kHttpTimeoutMs);
+
+  // The inflater's block is reserved before the request so gzip is only
+  // offered when it fits, and released as soon as the reply turns out not to
+  // need it (every 304 and identity body) or the body has been read.
+  InflateStream inflater;
+  const bool offerGzip =
+    ESP.getMaxAllocHeap() >= InflateStream::kHeapBytes + kInflateHeadroomBytes && inflater.reserve();
+
+  static const char *kCollectedHeaders[] = {
+    "Transfer-Encoding", "Content-Encoding", "ETag", "Last-Modified", "Retry-After"};
 
   HTTPClient http;
-  http.setTimeout(12000);
-  http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+  int code = 0;
+  for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+    const bool reused = pooled && client.connected();
+    http.setTimeout(kHttpTimeoutMs);
+    http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+    http.setReuse(pooled != nullptr);
 
-  if (!http.begin(client, url)) return false;
-  http.addHeader("User-Agent", "olympic-scoreboard-esp32");
-  http.addHeader("Accept", "application/json");
-  if (useMedalsAuth) {
-    http.addHeader("x-olyapiauth", kMedalsApiHeaderValue);
+    if (!http.begin(client, url)) return FetchResult::FAILED;
+    http.collectHeaders(kCollectedHeaders, 5);
+    http.addHeader("User-Agent", "olympic-scoreboard-esp32");
+    http.addHeader("Accept", "application/json");
+    if (offerGzip && !replaceAcceptEncoding(http, kAcceptEncodingGzip, 0)) inflater.release();
+    if (useMedalsAuth) {
+      http.addHeader("x-olyapiauth", kMedalsApiHeaderValue);
+    }
+    if (cached && cached->etag.length()) {
+      http.addHeader("If-None-Match", cached->etag);
+    }
+    if (cached && cached->lastModified.length()) {
+      http.addHeader("If-Modified-Since", cached->lastModified);
+    }
+
+    code = http.GET();
+    // A transport error on a reused socket usually means the server closed it
+    // while idle; retry once on a fresh connection.
+    if (code < 0 && reused) {
+      http.end();
+      client.stop();
+      continue;
+    }
+    break;
+  }
+  _lastHttpCode = code;
+
+  if (code == 304 && cached) {
+    http.end();
+    if (pooled) pooled->lastUsedMs = millis();
+    recordEndpointSuccess(endpoint);
+    return FetchResult::NOT_MODIFIED;
   }
 
-  const int code = http.GET();
   if (code != 200) {
     Serial.printf("HTTP %d: %s\n", code, url.c_str());
+    // Transport errors, throttling and server errors count against the
+    // endpoint; other 4xx mean this particular URL is wrong.
+    if (code < 0 || code == 429 || code >= 500) {
+      const long retryAfterSec = http.header("Retry-After").toInt();
+      recordEndpointFailure(endpoint, retryAfterSec > 0 ? (uint32_t)retryAfterSec * 1000UL : 0);
+    }
+    http.setReuse(false);
     http.end();
-    return false;
+    client.stop();
+    return FetchResult::FAILED;
+  }
+
+  if (cached) {
+    cached->etag = http.header("ETag");
+    cached->lastModified = http.header("Last-Modified");
   }
 
   const String transferEncoding = http.header("Transfer-Encoding");
+  const String contentEncoding = http.header("Content-Encoding");
   const int contentLen = http.getSize();
   const bool useChunked = transferEncoding.equalsIgnoreCase("chunked") || contentLen < 0;
+  const bool compressed = contentEncoding.length() && !contentEncoding.equalsIgnoreCase("identity");
+  if (!compressed) inflater.release();
   Stream &stream = http.getStream();
-  const auto nesting = DeserializationOption::NestingLimit(24);
-  DeserializationError err;
+  ChunkedStream chunked(stream);
+  Stream &framed = useChunked ? (Stream &)chunked : stream;
+  if (compressed) {
+    const size_t limit = useChunked ? SIZE_MAX : (size_t)contentLen;
+    if (contentEncoding.equalsIgnoreCase("gzip") || contentEncoding.equalsIgnoreCase("x-gzip")) {
+      inflater.begin(framed, InflateStream::Format::GZIP, limit);
+    } else if (contentEncoding.equalsIgnoreCase("deflate")) {
+      inflater.begin(framed, InflateStream::Format::ZLIB, limit);
+    } else {
+      Serial.printf("HTTP: unsupported Content-Encoding %s\n", contentEncoding.c_str());
+    }
+  }
+
+  Stream &decoded = compressed ? (Stream &)inflater : framed;
+  HashingStream body(decoded);
+  bool parsed = parser.parse(body);
+  const bool early = parsed && parser.stoppedEarly();
+  // A complete parse also checks the gzip trailer; an early stop cannot.
+  if (parsed && compressed && !early && !inflater.finish()) parsed = false;
+  inflater.release();
+  const uint32_t bodyHash = body.hash();
+  const size_t bodyRead = body.count();
+
+  bool reusable = (pooled != nullptr);
+  size_t skipped = 0;
   if (useChunked) {
-    ChunkedStream chunked(stream);
-    err = filter ? deserializeJson(doc, chunked, DeserializationOption::Filter(*filter), nesting)
-                 : deserializeJson(doc, chunked, nesting);
-  } else {
-    err = filter ? deserializeJson(doc, stream, DeserializationOption::Filter(*filter), nesting)
-                 : deserializeJson(doc, stream, nesting);
+    if (!parsed || !chunked.drain(early ? kMaxDrainBytes : SIZE_MAX)) reusable = false;
+    skipped = chunked.bytesSkipped();
+  } else if (!parsed) {
+    reusable = false;
+  } else if (contentLen > 0) {
+    // HTTPClient only discards bytes already buffered, so a tail still in
+    // flight would be read as the next response; skip it here or drop the
+    // socket.
+    const size_t consumed = compressed ? inflater.sourceBytes() : bodyRead;
+    skipped = ((size_t)contentLen > consumed) ? (size_t)contentLen - consumed : 0;
+    if (skipped && (!reusable || skipped > kMaxDrainBytes || skipBody(stream, skipped) != skipped)) {
+      reusable = false;
+    }
+  } else if (early) {
+    reusable = false;
+  }
+  if (early) {
+    Serial.printf("HTTP: %s stopped after %u B, %s %u B%s\n",
+                  kEndpointNames[(uint8_t)endpoint],
+                  (unsigned)bodyRead,
+                  reusable ? "drained" : "dropped",
+                  (unsigned)skipped,
+                  (!reusable && (useChunked || contentLen <= 0)) ? "+" : "");
   }
 
+  http.setReuse(reusable);
   http.end();
-  if (err) {
-    Serial.printf("JSON parse error: %s\n", err.c_str());
-    return false;
+  if (pooled) {
+    if (!reusable) client.stop();
+    pooled->lastUsedMs = millis();
   }
-  return true;
+  if (!parsed) {
+    if (cached) *cached = CachedValidators();
+    recordEndpointFailure(endpoint, 0);
+    return FetchResult::FAILED;
+  }
+  recordEndpointSuccess(endpoint);
+
+  if (cached) {
+    const bool unchanged = cached->bodyHash != 0 && cached->bodyHash == bodyHash;
+    cached->bodyHash = bodyHash;
+    if (unchanged) return FetchResult::NOT_MODIFIED;
+  }
+  return FetchResult::OK;
 }
 
-bool OlympicScoreboardClient::fetchMedalTable(MedalTableState &out, const String &favoriteCountryCode) {
+FetchResult OlympicScoreboardClient::fetchMedalTable(MedalTableState &out, const FavoriteSet &favorites) {
   out = MedalTableState();
+  out.favoriteCount = favorites.count();
 
-  JsonDocument filter;
-  filter[0]["countryName"] = true;
-  filter[0]["countryCode"] = true;
-  filter[0]["gold"] = true;
-  filter[0]["silver"] = true;
-  filter[0]["bronze"] = true;
-  filter[0]["medalTotal"] = true;
-  filter[0]["medalRank"] = true;
-  filter[0]["flagUrl"]["small"] = true;
-  filter[0]["flagUrl"]["medium"] = true;
+  const String url(kMedalsCountryUrl);
+  MedalTableHandler handler(out, favorites);
+  SaxResponseParser parser(handler);
+  const FetchResult result = httpGet(Endpoint::MEDALS_COUNTRY, url, parser, true, true);
+  if (result != FetchResult::OK) return result;
+  if (!handler.sawArray()) {
+    forgetValidators(url);
+    return FetchResult::FAILED;
+  }
 
-  JsonDocument doc;
-  if (!httpGetJson(String(kMedalsCountryUrl), doc, &filter, true)) {
-    return false;
-  }
-
-  const String fav = asUpper(favoriteCountryCode);
-  JsonArrayConst rows = doc.as<JsonArrayConst>();
-  if (rows.isNull()) return false;
-
-  for (JsonObjectConst row : rows) {
-    if (out.rowCount >= kMaxMedalRows) break;
-    MedalRow &dst = out.rows[out.rowCount++];
-
-    dst.countryName = String((const char *)(row["countryName"] | ""));
-    dst.countryCode = asUpper(String((const char *)(row["countryCode"] | "")));
-    dst.gold = (uint16_t)(row["gold"] | 0);
-    dst.silver = (uint16_t)(row["silver"] | 0);
-    dst.bronze = (uint16_t)(row["bronze"] | 0);
-    dst.total = (uint16_t)(row["medalTotal"] | 0);
-    dst.rank = (uint16_t)(row["medalRank"] | 0);
-    dst.flagUrlSmall = String((const char *)(row["flagUrl"]["small"] | ""));
-    dst.flagUrlMedium = String((const char *)(row["flagUrl"]["medium"] | ""));
-
-    if (dst.countryCode == fav) {
-      out.hasFavorite = true;
-      out.favoriteIndex = (int8_t)(out.rowCount - 1);
-      out.favoriteGold = dst.gold;
-      out.favoriteSilver = dst.silver;
-      out.favoriteBronze = dst.bronze;
-      out.favoriteTotal = dst.total;
-    }
+  out.valid = true;
+  return FetchResult::OK;
+}
+
+// Sort key and position in the feed's data array of one usable row.
+struct ScheduleKey {
+  time_t startEpoch;
+  uint32_t eventId;
+  uint16_t index;
+
+  // Ties on start time are broken by id so equal-start rows keep their
+  // order from poll to poll.
+  bool after(const ScheduleKey &other) const {
+    return startEpoch != other.startEpoch ? startEpoch > other.startEpoch : eventId > other.eventId;
   }
+};
 
-  if (!out.hasFavorite) {
-    out.favoriteGold = 0;
-    out.favoriteSilver = 0;
-    out.favoriteBronze = 0;
-    out.favoriteTotal = 0;
+// Fills `row` from one schedule item; false if the item is not a usable
+// Olympic event.
+static bool readScheduleRow(JsonObjectConst item, CompetitionRow &row) {
+  JsonObjectConst singleEvent = item["singleEvent"].as<JsonObjectConst>();
+  if (singleEvent.isNull()) return false;
+
+  const char *gameType = singleEvent["gameType"] | "";
+  if (*gameType && strcasecmp(gameType, "olympics") != 0) return false;
+
+  row = CompetitionRow();
+  row.startEpoch = (time_t)(singleEvent["startDate"] | 0);
+  if (row.startEpoch <= 0) return false;
+  row.status = parseEventStatus(singleEvent["status"] | "");
+  row.isMedalSession = singleEvent["isMedalSession"] | false;
+  strlcpy(row.title, singleEvent["shortTitle"] | "", sizeof(row.title));
+  if (!row.title[0]) {
+    strlcpy(row.title, singleEvent["title"] | "", sizeof(row.title));
   }
-  out.valid = true;
+
+  JsonVariantConst sportsVar = item["sports"];
+  JsonObjectConst sportObj;
+  if (sportsVar.is<JsonArrayConst>()) {
+    JsonArrayConst arr = sportsVar.as<JsonArrayConst>();
+    if (!arr.isNull() && arr.size() > 0) sportObj = arr[0];
+  } else if (sportsVar.is<JsonObjectConst>()) {
+    sportObj = sportsVar.as<JsonObjectConst>();
+  }
+
+  if (!sportObj.isNull()) {
+    copyUpper(row.sportCode, sizeof(row.sportCode), sportObj["code"] | "");
+    strlcpy(row.sportName, sportObj["shortDisplayTitle"] | "", sizeof(row.sportName));
+    if (!row.sportName[0]) strlcpy(row.sportName, sportObj["title"] | "", sizeof(row.sportName));
+  }
+
+  if (!row.sportCode[0]) strlcpy(row.sportCode, "---", sizeof(row.sportCode));
+  if (!row.sportName[0]) strlcpy(row.sportName, "Olympics", sizeof(row.sportName));
+  if (!row.title[0]) strlcpy(row.title, row.sportName, sizeof(row.title));
+
+  JsonVariantConst id = singleEvent["id"];
+  char idText[24] = {};
+  if (id.is<const char *>()) {
+    strlcpy(idText, id.as<const char *>(), sizeof(idText));
+  } else if (id.is<uint32_t>()) {
+    snprintf(idText, sizeof(idText), "%lu", (unsigned long)id.as<uint32_t>());
+  }
+  uint32_t h = 2166136261u;
+  if (idText[0]) {
+    h = hashText(h, idText);
+  } else {
+    h = hashText(hashText(h, row.sportCode), "/");
+    h = hashText(h, singleEvent["title"] | (const char *)row.title);
+  }
+  row.eventId = h;
   return true;
 }
 
-void OlympicScoreboardClient::sortScheduleRows(DailyScheduleState &schedule) {
-  for (uint8_t i = 0; i < schedule.rowCount; ++i) {
-    for (uint8_t j = (uint8_t)(i + 1); j < schedule.rowCount; ++j) {
-      if (schedule.rows[j].startEpoch < schedule.rows[i].startEpoch) {
-        CompetitionRow tmp = schedule.rows[i];
-        schedule.rows[i] = schedule.rows[j];
-        schedule.rows[j] = tmp;
-      }
+static bool sameRow(const CompetitionRow &a, const CompetitionRow &b) {
+  return a.eventId == b.eventId && a.startEpoch == b.startEpoch && a.status == b.status &&
+         a.isMedalSession == b.isMedalSession && strcmp(a.sportCode, b.sportCode) == 0 &&
+         strcmp(a.sportName, b.sportName) == 0 && strcmp(a.title, b.title) == 0;
+}
+
+bool mergeSchedulePage(DailyScheduleState &live, const DailyScheduleState &fresh) {
+  ScheduleChanges changes;
+  const bool samePage = live.valid && fresh.valid && live.firstRow == fresh.firstRow &&
+                        strcmp(live.dateYmd, fresh.dateYmd) == 0;
+  if (!samePage) {
+    const bool hasNextMedal = live.hasNextMedal;
+    const CompetitionRow nextMedal = live.nextMedal;
+    const uint32_t revision = live.revision;
+    live = fresh;
+    live.hasNextMedal = hasNextMedal;
+    live.nextMedal = nextMedal;
+    live.revision = revision + 1;
+    live.changes = ScheduleChanges();
+    live.changes.reset = true;
+    return true;
+  }
+
+  // Pair each fresh row with an unclaimed live row of the same id. Pages are
+  // mostly unchanged, so the search starts at the same position.
+  uint64_t claimed = 0;
+  for (uint8_t i = 0; i < fresh.rowCount; ++i) {
+    const CompetitionRow &row = fresh.rows[i];
+    int8_t match = -1;
+    for (uint8_t n = 0; n < live.rowCount && match < 0; ++n) {
+      const uint8_t j = (uint8_t)((i + n) % live.rowCount);
+      if (!(claimed & (1ULL << j)) && live.rows[j].eventId == row.eventId) match = (int8_t)j;
     }
+    const uint64_t bit = 1ULL << i;
+    if (match < 0) {
+      changes.added |= bit;
+    } else {
+      claimed |= 1ULL << match;
+      const CompetitionRow &prev = live.rows[match];
+      if (prev.status != row.status) changes.statusChanged |= bit;
+      if (prev.startEpoch != row.startEpoch) changes.timeChanged |= bit;
+    }
+    if (i >= live.rowCount || !sameRow(live.rows[i], row)) changes.redraw |= bit;
+  }
+  for (uint8_t j = 0; j < live.rowCount; ++j) {
+    if (!(claimed & (1ULL << j))) changes.removed++;
+    if (j >= fresh.rowCount) changes.redraw |= 1ULL << j;
+  }
+  // The empty-day panel replaces the row list entirely.
+  changes.reset = (live.rowCount == 0) != (fresh.rowCount == 0);
+
+  const bool totalChanged = live.totalRows != fresh.totalRows;
+  if (!changes.any() && !totalChanged) return false;
+
+  for (uint8_t i = 0; i < fresh.rowCount; ++i) {
+    if (changes.redraw & (1ULL << i)) live.rows[i] = fresh.rows[i];
   }
+  live.rowCount = fresh.rowCount;
+  live.totalRows = fresh.totalRows;
+  live.revision++;
+  live.changes = changes;
+  return true;
 }
 
-bool OlympicScoreboardClient::fetchDailySchedule(DailyScheduleState &out, const String &startDateYmd) {
+FetchResult OlympicScoreboardClient::fetchDailySchedule(DailyScheduleState &out,
+                                                        const String &startDateYmd,
+                                                        ScheduleRowSink *sink,
+                                                        uint16_t firstRow) {
   out = DailyScheduleState();
-  out.dateYmd = startDateYmd;
+  strlcpy(out.dateYmd, startDateYmd.c_str(), sizeof(out.dateYmd));
+  out.firstRow = firstRow;
 
-  if (startDateYmd.length() < 8) return false;
+  if (startDateYmd.length() < 8) return FetchResult::FAILED;
 
   JsonDocument filter;
+  filter["data"][0]["singleEvent"]["id"] = true;
   filter["data"][0]["singleEvent"]["title"] = true;
   filter["data"][0]["singleEvent"]["shortTitle"] = true;
   filter["data"][0]["singleEvent"]["startDate"] = true;
@@ -249,183 +801,390 @@ bool OlympicScoreboardClient::fetchDailySchedule(DailyScheduleState &out, const
   filter["data"][0]["sports"][0]["title"] = true;
 
   JsonDocument doc;
-  String url = String(kScheduleUrlPrefix) + startDateYmd;
-  if (!httpGetJson(url, doc, &filter, false)) {
-    String compact = startDateYmd;
-    compact.replace("-", "");
-    if (compact == startDateYmd) return false;
+  JsonDocumentParser parser(doc, filter);
+  // The feed has accepted both YYYY-MM-DD and YYYYMMDD. Once one works, stick
+  // with it; the other is only tried while the format is unknown.
+  String compact = startDateYmd;
+  compact.replace("-", "");
+  const bool canCompact = compact != startDateYmd;
+  const bool compactFirst = canCompact && _scheduleDateFormat == ScheduleDateFormat::COMPACT;
+  String url = String(kScheduleUrlPrefix) + (compactFirst ? compact : startDateYmd);
+  FetchResult result = httpGet(Endpoint::SCHEDULE, url, parser, false, true);
+  bool usedCompact = compactFirst;
+  if (result == FetchResult::FAILED && canCompact && _scheduleDateFormat == ScheduleDateFormat::UNKNOWN &&
+      _lastHttpCode >= 400 && _lastHttpCode < 500 && _lastHttpCode != 429) {
     url = String(kScheduleUrlPrefix) + compact;
-    if (!httpGetJson(url, doc, &filter, false)) return false;
+    result = httpGet(Endpoint::SCHEDULE, url, parser, false, true);
+    usedCompact = true;
+  }
+  if (result == FetchResult::FAILED) {
+    // A rejected URL with a remembered format means the feed changed; go back
+    // to probing both on the next poll.
+    if (_lastHttpCode >= 400 && _lastHttpCode < 500 && _lastHttpCode != 429) {
+      _scheduleDateFormat = ScheduleDateFormat::UNKNOWN;
+    }
+    return result;
   }
+  if (canCompact) {
+    _scheduleDateFormat = usedCompact ? ScheduleDateFormat::COMPACT : ScheduleDateFormat::DASHED;
+  }
+  if (result != FetchResult::OK) return result;
 
   JsonArrayConst data = doc["data"].as<JsonArrayConst>();
-  if (data.isNull()) return false;
+  if (data.isNull()) {
+    forgetValidators(url);
+    return FetchResult::FAILED;
+  }
 
+  // Sort an index of (start, position) pairs rather than the rows, so the
+  // whole day can be ordered without holding it in RAM. Rows are then built
+  // in start order straight from the document.
+  static ScheduleKey keys[kMaxDayRows];
+  uint16_t keyCount = 0;
+  uint16_t index = 0;
+  CompetitionRow row;
   for (JsonObjectConst item : data) {
-    if (out.rowCount >= kMaxScheduleRows) break;
-    JsonObjectConst singleEvent = item["singleEvent"].as<JsonObjectConst>();
-    if (singleEvent.isNull()) continue;
-
-    const String gameType = String((const char *)(singleEvent["gameType"] | ""));
-    if (gameType.length() && !gameType.equalsIgnoreCase("olympics")) continue;
-
-    CompetitionRow row;
-    row.startEpoch = (time_t)(singleEvent["startDate"] | 0);
-    if (row.startEpoch <= 0) continue;
-    row.status = String((const char *)(singleEvent["status"] | ""));
-    row.isMedalSession = singleEvent["isMedalSession"] | false;
-    row.title = String((const char *)(singleEvent["shortTitle"] | ""));
-    if (!row.title.length()) {
-      row.title = String((const char *)(singleEvent["title"] | ""));
-    }
-
-    JsonVariantConst sportsVar = item["sports"];
-    JsonObjectConst sportObj;
-    if (sportsVar.is<JsonArrayConst>()) {
-      JsonArrayConst arr = sportsVar.as<JsonArrayConst>();
-      if (!arr.isNull() && arr.size() > 0) sportObj = arr[0];
-    } else if (sportsVar.is<JsonObjectConst>()) {
-      sportObj = sportsVar.as<JsonObjectConst>();
+    if (keyCount < kMaxDayRows && readScheduleRow(item, row)) {
+      const ScheduleKey key = {row.startEpoch, row.eventId, index};
+      uint16_t pos = keyCount++;
+      while (pos > 0 && keys[pos - 1].after(key)) {
+        keys[pos] = keys[pos - 1];
+        pos--;
+      }
+      keys[pos] = key;
     }
+    index++;
+  }
 
-    if (!sportObj.isNull()) {
-      row.sportCode = String((const char *)(sportObj["code"] | ""));
-      row.sportName = String((const char *)(sportObj["shortDisplayTitle"] | ""));
-      if (!row.sportName.length()) row.sportName = String((const char *)(sportObj["title"] | ""));
+  uint32_t rowsCrc = 0;
+  if (sink) {
+    for (uint16_t i = 0; i < keyCount; ++i) {
+      readScheduleRow(data[keys[i].index].as<JsonObjectConst>(), row);
+      rowsCrc = crc32_le(rowsCrc, (const uint8_t *)&row, sizeof(row));
     }
+  }
+  const bool storing = sink && sink->begin(out.dateYmd, keyCount, rowsCrc);
+  bool stored = storing;
+  for (uint16_t i = 0; i < keyCount; ++i) {
+    readScheduleRow(data[keys[i].index].as<JsonObjectConst>(), row);
+    if (stored) stored = sink->write(row);
+    if (i >= firstRow && out.rowCount < kMaxScheduleRows) out.rows[out.rowCount++] = row;
+  }
+  // Without the stored rows a later 304 would leave flash without this day,
+  // so make the next poll fetch it in full.
+  if (storing && !sink->end(stored)) forgetValidators(url);
 
-    if (!row.sportCode.length()) row.sportCode = "---";
-    row.sportCode.toUpperCase();
-    if (!row.sportName.length()) row.sportName = "Olympics";
-    if (!row.title.length()) row.title = row.sportName;
+  out.totalRows = keyCount;
+  out.valid = true;
+  return FetchResult::OK;
+}
 
-    out.rows[out.rowCount++] = row;
+bool OlympicScoreboardClient::fetchSportCounts(const FavoriteSet &favorites,
+                                               const char *sportCode,
+                                               SportMedalCounts (&outCounts)[kMaxFavorites]) {
+  uint16_t counts[kMaxFavorites][3] = {};
+  SportCountsHandler handler(favorites, counts);
+  SaxResponseParser parser(handler);
+  const String url = String(kMedalsSportUrlPrefix) + String(sportCode);
+  const bool ok = httpGet(Endpoint::MEDALS_SPORT, url, parser, true) == FetchResult::OK && handler.sawArray();
+  for (uint8_t f = 0; f < kMaxFavorites; ++f) {
+    outCounts[f].gold = counts[f][(uint8_t)MedalType::GOLD];
+    outCounts[f].silver = counts[f][(uint8_t)MedalType::SILVER];
+    outCounts[f].bronze = counts[f][(uint8_t)MedalType::BRONZE];
   }
+  return ok;
+}
 
-  sortScheduleRows(out);
-  out.valid = true;
+bool OlympicScoreboardClient::primeFavoriteSportBaseline(const MedalTableState &curr,
+                                                         const FavoriteSet &favorites,
+                                                         const bool *which) {
+  static SportMedalCounts latest[kWinterSportCount][kMaxFavorites];
+  for (uint8_t i = 0; i < kWinterSportCount; ++i) {
+    if (!fetchSportCounts(favorites, kWinterSports[i].code, latest[i])) return false;
+    delay(10);
+    yield();
+  }
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    if (which && !which[f]) continue;
+    for (uint8_t i = 0; i < kWinterSportCount; ++i) {
+      _sportBaseline[f][i] = latest[i][f];
+    }
+    _sportBaselineValid[f] = true;
+    saveSportBaseline(curr, favorites, f);
+  }
   return true;
 }
 
-bool OlympicScoreboardClient::fetchFavoriteSportCountsOne(const String &favoriteCountryCode,
-                                                          const char *sportCode,
-                                                          SportMedalCounts &outCounts) {
-  outCounts = SportMedalCounts();
+// NVS keys are limited to 15 characters: "sportBase" plus the NOC code.
+static String sportBaselineKey(const char *countryCode) {
+  return String(kPrefsSportBaselineKey) + countryCode;
+}
 
-  JsonDocument filter;
-  filter[0]["countryCode"] = true;
-  filter[0]["gold"] = true;
-  filter[0]["silver"] = true;
-  filter[0]["bronze"] = true;
+void OlympicScoreboardClient::saveSportBaseline(const MedalTableState &curr,
+                                                const FavoriteSet &favorites,
+                                                uint8_t fav) {
+  const MedalRow &row = curr.favorites[fav].row;
+  PersistedSportBaseline blob = {};
+  blob.version = kSportBaselineVersion;
+  strlcpy(blob.competition, kCompetitionCode, sizeof(blob.competition));
+  strlcpy(blob.country, favorites.code(fav), sizeof(blob.country));
+  blob.savedEpoch = (uint32_t)time(nullptr);
+  blob.tableGold = row.gold;
+  blob.tableSilver = row.silver;
+  blob.tableBronze = row.bronze;
+  memcpy(blob.counts, _sportBaseline[fav], sizeof(blob.counts));
 
-  JsonDocument doc;
-  const String url = String(kMedalsSportUrlPrefix) + String(sportCode);
-  if (!httpGetJson(url, doc, &filter, true)) return false;
-
-  const String fav = asUpper(favoriteCountryCode);
-  JsonArrayConst rows = doc.as<JsonArrayConst>();
-  if (rows.isNull()) return false;
-
-  for (JsonObjectConst row : rows) {
-    String code = asUpper(String((const char *)(row["countryCode"] | "")));
-    if (code != fav) continue;
-    outCounts.gold = (uint16_t)(row["gold"] | 0);
-    outCounts.silver = (uint16_t)(row["silver"] | 0);
-    outCounts.bronze = (uint16_t)(row["bronze"] | 0);
-    break;
-  }
-  return true;
+  Preferences prefs;
+  if (!prefs.begin(kPrefsNamespace, false)) return;
+  prefs.putBytes(sportBaselineKey(favorites.code(fav)).c_str(), &blob, sizeof(blob));
+  prefs.end();
 }
 
-bool OlympicScoreboardClient::fetchFavoriteSportCounts(const String &favoriteCountryCode,
-                                                       SportMedalCounts *outCounts,
-                                                       uint8_t count) {
-  bool ok = true;
-  for (uint8_t i = 0; i < count; ++i) {
-    if (!fetchFavoriteSportCountsOne(favoriteCountryCode, kWinterSports[i].code, outCounts[i])) {
-      ok = false;
+void OlympicScoreboardClient::loadSportBaseline(const FavoriteSet &favorites) {
+  Preferences prefs;
+  if (!prefs.begin(kPrefsNamespace, true)) return;
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    _persistedBaselineValid[f] = false;
+    const String key = sportBaselineKey(favorites.code(f));
+    PersistedSportBaseline blob;
+    const bool read = prefs.getBytesLength(key.c_str()) == sizeof(blob) &&
+                      prefs.getBytes(key.c_str(), &blob, sizeof(blob)) == sizeof(blob);
+    if (!read) continue;
+
+    if (blob.version != kSportBaselineVersion ||
+        strncmp(blob.competition, kCompetitionCode, sizeof(blob.competition)) != 0 ||
+        strncmp(blob.country, favorites.code(f), sizeof(blob.country)) != 0) {
+      Serial.printf("MEDALS: stored %s sport baseline ignored (different competition)\n", favorites.code(f));
+      continue;
     }
-    delay(10);
-    yield();
+
+    memcpy(_sportBaseline[f], blob.counts, sizeof(blob.counts));
+    _sportBaselineValid[f] = true;
+    _persistedBaselineValid[f] = true;
+    _persistedTotals[f].gold = blob.tableGold;
+    _persistedTotals[f].silver = blob.tableSilver;
+    _persistedTotals[f].bronze = blob.tableBronze;
+    Serial.printf("MEDALS: %s sport baseline restored (saved at %lu)\n",
+                  favorites.code(f),
+                  (unsigned long)blob.savedEpoch);
   }
-  return ok;
+  prefs.end();
 }
 
-bool OlympicScoreboardClient::primeFavoriteSportBaseline(const String &favoriteCountryCode) {
-  SportMedalCounts latest[kWinterSportCount];
-  if (!fetchFavoriteSportCounts(favoriteCountryCode, latest, kWinterSportCount)) {
-    return false;
+bool OlympicScoreboardClient::syncSportBaseline(const MedalTableState &curr,
+                                                const DailyScheduleState &schedule,
+                                                const FavoriteSet &favorites,
+                                                MedalAlertEvent *missed,
+                                                uint8_t maxMissed,
+                                                uint8_t &missedCount) {
+  missedCount = 0;
+  if (!curr.valid) return false;
+
+  MedalChangeEvent gained[kMaxFavorites];
+  uint8_t gainedCount = 0;
+  bool needsSweep[kMaxFavorites] = {};
+  bool anySweep = false;
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    const MedalRow &row = curr.favorites[f].row;
+    const SportMedalCounts &saved = _persistedTotals[f];
+    if (_persistedBaselineValid[f]) {
+      _persistedBaselineValid[f] = false;
+      if (row.gold == saved.gold && row.silver == saved.silver && row.bronze == saved.bronze) continue;
+
+      if (row.gold >= saved.gold && row.silver >= saved.silver && row.bronze >= saved.bronze) {
+        MedalChangeEvent &change = gained[gainedCount++];
+        change = MedalChangeEvent();
+        change.favorite = (int8_t)f;
+        strlcpy(change.countryCode, favorites.code(f), sizeof(change.countryCode));
+        change.row = curr.favorites[f].index;
+        change.gold = (int16_t)(row.gold - saved.gold);
+        change.silver = (int16_t)(row.silver - saved.silver);
+        change.bronze = (int16_t)(row.bronze - saved.bronze);
+        continue;
+      }
+    }
+    needsSweep[f] = true;
+    anySweep = true;
+  }
+
+  if (gainedCount) {
+    missedCount = buildFavoriteMedalAlerts(gained, gainedCount, curr, schedule, favorites, missed, maxMissed);
   }
+  return !anySweep || primeFavoriteSportBaseline(curr, favorites, needsSweep);
+}
+
+static int winterSportIndexFor(const CompetitionRow &row) {
+  const size_t rowNameLen = strlen(row.sportName);
   for (uint8_t i = 0; i < kWinterSportCount; ++i) {
-    _sportBaseline[i] = latest[i];
+    const WinterSportDef &def = kWinterSports[i];
+    if (strcasecmp(row.sportCode, def.code) == 0) return i;
+    if (rowNameLen < 4) continue;
+    const size_t defNameLen = strlen(def.name);
+    const size_t n = (rowNameLen < defNameLen) ? rowNameLen : defNameLen;
+    if (strncasecmp(row.sportName, def.name, n) == 0) return i;
   }
-  _sportBaselineValid = true;
-  return true;
+  return -1;
 }
 
-bool OlympicScoreboardClient::buildFavoriteMedalAlert(const MedalTableState &prev,
-                                                      const MedalTableState &curr,
-                                                      const String &favoriteCountryCode,
-                                                      MedalAlertEvent &out) {
-  out = MedalAlertEvent();
-  if (!prev.valid || !curr.valid) return false;
+uint8_t OlympicScoreboardClient::rankCandidateSports(const DailyScheduleState &schedule,
+                                                     uint8_t *out,
+                                                     uint8_t maxOut) const {
+  const time_t now = time(nullptr);
+  const bool clockValid = now > 1577836800;
 
-  const int dGold = (int)curr.favoriteGold - (int)prev.favoriteGold;
-  const int dSilver = (int)curr.favoriteSilver - (int)prev.favoriteSilver;
-  const int dBronze = (int)curr.favoriteBronze - (int)prev.favoriteBronze;
-  if (dGold <= 0 && dSilver <= 0 && dBronze <= 0) return false;
+  // Best (most recent) qualifying medal session per sport; live sessions win.
+  time_t score[kWinterSportCount] = {};
+  for (uint8_t r = 0; r < schedule.rowCount; ++r) {
+    const CompetitionRow &row = schedule.rows[r];
+    if (!row.isMedalSession || row.status == EventStatus::SCHEDULED) continue;
+    if (row.status != EventStatus::LIVE && clockValid) {
+      if (row.startEpoch > now || now - row.startEpoch > kAttributionWindowSec) continue;
+    }
+    const int idx = winterSportIndexFor(row);
+    if (idx < 0) continue;
+    const time_t s = (row.status == EventStatus::LIVE) ? row.startEpoch + kAttributionWindowSec : row.startEpoch;
+    if (s > score[idx]) score[idx] = s;
+  }
 
-  MedalType alertType = MedalType::UNKNOWN;
-  uint8_t alertDelta = 0;
-  if (dGold > 0) {
-    alertType = MedalType::GOLD;
-    alertDelta = (uint8_t)dGold;
-  } else if (dSilver > 0) {
-    alertType = MedalType::SILVER;
-    alertDelta = (uint8_t)dSilver;
-  } else if (dBronze > 0) {
-    alertType = MedalType::BRONZE;
-    alertDelta = (uint8_t)dBronze;
+  uint8_t count = 0;
+  while (count < maxOut) {
+    int best = -1;
+    for (uint8_t i = 0; i < kWinterSportCount; ++i) {
+      if (score[i] > 0 && (best < 0 || score[i] > score[best])) best = i;
+    }
+    if (best < 0) break;
+    out[count++] = (uint8_t)best;
+    score[best] = 0;
   }
+  return count;
+}
 
-  out.valid = true;
-  out.medalType = alertType;
-  out.delta = alertDelta;
-  out.sportCode = "---";
-  out.sportName = "Olympic Event";
+void OlympicScoreboardClient::attributeSport(const FavoriteSet &favorites,
+                                             uint8_t sportIdx,
+                                             SportAttribution &acc) {
+  acc.queried[sportIdx] = true;
+  SportMedalCounts latest[kMaxFavorites];
+  if (!fetchSportCounts(favorites, kWinterSports[sportIdx].code, latest)) return;
+
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    if (!acc.involved[f]) continue;
+    SportMedalCounts &base = _sportBaseline[f][sportIdx];
+    const int d[3] = {(int)latest[f].gold - (int)base.gold,
+                      (int)latest[f].silver - (int)base.silver,
+                      (int)latest[f].bronze - (int)base.bronze};
+    base = latest[f];
+    for (uint8_t c = 0; c < 3; ++c) {
+      if (d[c] <= 0) continue;
+      acc.explained[f][c] += d[c];
+      acc.gained[f][sportIdx][c] = (uint8_t)min(d[c], 255);
+    }
+  }
+}
 
-  SportMedalCounts latest[kWinterSportCount];
-  if (fetchFavoriteSportCounts(favoriteCountryCode, latest, kWinterSportCount)) {
-    int bestIdx = -1;
-    int bestDelta = 0;
+// Splits `delta` medals of one colour into alerts per sport that explains
+// them, then one unattributed alert for any remainder.
+static uint8_t appendColourAlerts(const MedalAlertEvent &base,
+                                  MedalType type,
+                                  int delta,
+                                  const uint8_t (*gained)[3],
+                                  MedalAlertEvent *out,
+                                  uint8_t count,
+                                  uint8_t maxOut) {
+  for (uint8_t i = 0; i < kWinterSportCount && delta > 0 && count < maxOut; ++i) {
+    const int n = min((int)gained[i][(uint8_t)type], delta);
+    if (n <= 0) continue;
+    MedalAlertEvent &ev = out[count++];
+    ev = base;
+    ev.medalType = type;
+    ev.delta = (uint8_t)n;
+    strlcpy(ev.sportCode, kWinterSports[i].code, sizeof(ev.sportCode));
+    strlcpy(ev.sportName, kWinterSports[i].name, sizeof(ev.sportName));
+    delta -= n;
+  }
+  if (delta > 0 && count < maxOut) {
+    MedalAlertEvent &ev = out[count++];
+    ev = base;
+    ev.medalType = type;
+    ev.delta = (uint8_t)min(delta, 255);
+    strlcpy(ev.sportCode, "---", sizeof(ev.sportCode));
+    strlcpy(ev.sportName, "Olympic Event", sizeof(ev.sportName));
+  }
+  return count;
+}
+
+uint8_t OlympicScoreboardClient::buildFavoriteMedalAlerts(const MedalChangeEvent *changes,
+                                                          uint8_t changeCount,
+                                                          const MedalTableState &curr,
+                                                          const DailyScheduleState &schedule,
+                                                          const FavoriteSet &favorites,
+                                                          MedalAlertEvent *out,
+                                                          uint8_t maxOut) {
+  if (!curr.valid) return 0;
 
-    if (_sportBaselineValid) {
+  static SportAttribution acc;
+  acc = SportAttribution();
+  int wanted[kMaxFavorites][3] = {};
+  bool unprimed[kMaxFavorites] = {};
+  bool anyInvolved = false;
+  bool anyUnprimed = false;
+  for (uint8_t i = 0; i < changeCount; ++i) {
+    const MedalChangeEvent &change = changes[i];
+    if (change.favorite < 0 || change.favorite >= favorites.count()) continue;
+    const uint8_t f = (uint8_t)change.favorite;
+    wanted[f][(uint8_t)MedalType::GOLD] = max((int)change.gold, 0);
+    wanted[f][(uint8_t)MedalType::SILVER] = max((int)change.silver, 0);
+    wanted[f][(uint8_t)MedalType::BRONZE] = max((int)change.bronze, 0);
+    if (!wanted[f][0] && !wanted[f][1] && !wanted[f][2]) continue;
+    if (_sportBaselineValid[f]) {
+      acc.involved[f] = true;
+      anyInvolved = true;
+    } else {
+      // Nothing to diff against yet; the sweep below only establishes it.
+      unprimed[f] = true;
+      anyUnprimed = true;
+    }
+  }
+
+  if (anyInvolved) {
+    uint8_t candidates[kMaxCandidateSports];
+    const uint8_t candidateCount = rankCandidateSports(schedule, candidates, kMaxCandidateSports);
+    for (uint8_t i = 0; i < candidateCount; ++i) {
+      attributeSport(favorites, candidates[i], acc);
+    }
+
+    bool explained = true;
+    for (uint8_t f = 0; f < favorites.count(); ++f) {
+      for (uint8_t c = 0; c < 3; ++c) {
+        explained = explained && acc.explained[f][c] >= wanted[f][c];
+      }
+    }
+    if (!explained) {
       for (uint8_t i = 0; i < kWinterSportCount; ++i) {
-        int d = 0;
-        if (alertType == MedalType::GOLD) {
-          d = (int)latest[i].gold - (int)_sportBaseline[i].gold;
-        } else if (alertType == MedalType::SILVER) {
-          d = (int)latest[i].silver - (int)_sportBaseline[i].silver;
-        } else if (alertType == MedalType::BRONZE) {
-          d = (int)latest[i].bronze - (int)_sportBaseline[i].bronze;
-        }
-        if (d > bestDelta) {
-          bestDelta = d;
-          bestIdx = i;
-        }
+        if (acc.queried[i]) continue;
+        attributeSport(favorites, i, acc);
+        delay(10);
       }
     }
+    Serial.printf("MEDALS: attribution queried %u sport(s)%s\n",
+                  (unsigned)(explained ? candidateCount : kWinterSportCount),
+                  explained ? "" : " (full sweep)");
 
-    for (uint8_t i = 0; i < kWinterSportCount; ++i) {
-      _sportBaseline[i] = latest[i];
+    for (uint8_t f = 0; f < favorites.count(); ++f) {
+      if (acc.involved[f]) saveSportBaseline(curr, favorites, f);
     }
-    _sportBaselineValid = true;
+  }
+  if (anyUnprimed) primeFavoriteSportBaseline(curr, favorites, unprimed);
 
-    if (bestIdx >= 0) {
-      out.sportCode = kWinterSports[bestIdx].code;
-      out.sportName = kWinterSports[bestIdx].name;
+  uint8_t count = 0;
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    MedalAlertEvent base;
+    base.valid = true;
+    strlcpy(base.countryCode, favorites.code(f), sizeof(base.countryCode));
+    strlcpy(base.countryName, curr.favorites[f].row.countryName, sizeof(base.countryName));
+    if (!base.countryName[0]) strlcpy(base.countryName, base.countryCode, sizeof(base.countryName));
+    for (uint8_t c = 0; c < 3; ++c) {
+      count = appendColourAlerts(base, (MedalType)c, wanted[f][c], acc.gained[f], out, count, maxOut);
     }
   }
-
-  return true;
+  return count;
 }
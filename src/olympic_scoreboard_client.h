@@ -1,7 +1,10 @@
 #pragma once
 
 #include <Arduino.h>
-#include <ArduinoJson.h>
+
+#include <type_traits>
+
+#include "favorite_set.h"
 
 enum class MedalType : uint8_t {
   GOLD,
@@ -10,15 +13,43 @@ enum class MedalType : uint8_t {
   UNKNOWN
 };
 
+// Outcome of a feed poll. NOT_MODIFIED means the server (or the body hash)
+// confirmed the previous payload is still current. The output struct is reset
+// before every request, so on anything but OK it holds no usable state:
+// callers parse into scratch and keep what they already have.
+enum class FetchResult : uint8_t {
+  OK,
+  NOT_MODIFIED,
+  FAILED
+};
+
 static const uint8_t kMaxMedalRows = 24;
 static const uint8_t kMaxScheduleRows = 40;
+// Rows kept per day in flash (see ScheduleCache); RAM holds a kMaxScheduleRows
+// page of them.
+static const uint16_t kMaxDayRows = 255;
 static const uint8_t kWinterSportCount = 16;
 
+// Text capacities (excluding the terminator) for the fixed-size records below.
+// Everything the UI shows is elided well before these limits.
+static const uint8_t kNocCodeLen = 3;
+static const uint8_t kCountryNameLen = 31;
+static const uint8_t kSportCodeLen = 7;
+static const uint8_t kSportNameLen = 23;
+static const uint8_t kEventTitleLen = 47;
+
+enum class EventStatus : uint8_t {
+  UNKNOWN,
+  SCHEDULED,
+  LIVE,
+  FINAL
+};
+
+// The records below are plain data (no String members) so whole states are
+// copied with a memcpy and a poll allocates nothing per row.
 struct MedalRow {
-  String countryCode;
-  String countryName;
-  String flagUrlSmall;
-  String flagUrlMedium;
+  char countryCode[kNocCodeLen + 1] = {};
+  char countryName[kCountryNameLen + 1] = {};
   uint16_t gold = 0;
   uint16_t silver = 0;
   uint16_t bronze = 0;
@@ -26,51 +57,176 @@ struct MedalRow {
   uint16_t rank = 0;
 };
 
+// A followed country's line of the table, kept even when it ranks below the
+// stored rows.
+struct FavoriteStanding {
+  bool present = false;  // listed in the feed
+  int8_t index = -1;     // position in MedalTableState::rows, -1 if not stored
+  MedalRow row;
+};
+
 struct MedalTableState {
   bool valid = false;
   uint8_t rowCount = 0;
   MedalRow rows[kMaxMedalRows];
-  bool hasFavorite = false;
-  int8_t favoriteIndex = -1;
-  uint16_t favoriteGold = 0;
-  uint16_t favoriteSilver = 0;
-  uint16_t favoriteBronze = 0;
-  uint16_t favoriteTotal = 0;
+  // Indexed like the FavoriteSet the table was fetched with.
+  uint8_t favoriteCount = 0;
+  FavoriteStanding favorites[kMaxFavorites];
+  // Bumped by every change; changedRows has a bit per row position that
+  // differs from revision - 1.
+  uint32_t revision = 0;
+  uint32_t changedRows = 0;
+};
+
+static_assert(kMaxMedalRows <= 32, "MedalTableState::changedRows holds one bit per row");
+
+enum class MedalEventKind : uint8_t {
+  MEDALS,   // medal counts changed; deltas can be negative after a correction
+  RANK,     // rank moved with no medal change
+  ENTERED,  // country is new to the kept rows
+  LEFT      // country dropped out of the kept rows
+};
+
+// One country's change between two consecutive medal tables (see MedalDiff).
+struct MedalChangeEvent {
+  MedalEventKind kind = MedalEventKind::MEDALS;
+  int8_t favorite = -1;  // index in the FavoriteSet, -1 if not followed
+  char countryCode[kNocCodeLen + 1] = {};
+  int8_t row = -1;  // position in the newer table; -1 when not kept
+  int16_t gold = 0;
+  int16_t silver = 0;
+  int16_t bronze = 0;
+  uint16_t fromRank = 0;
+  uint16_t toRank = 0;
 };
 
 struct CompetitionRow {
+  // Stable across polls: a hash of the feed's event id, or of sport and title
+  // for items without one.
+  uint32_t eventId = 0;
   time_t startEpoch = 0;
-  String status;
-  String sportCode;
-  String sportName;
-  String title;
+  EventStatus status = EventStatus::UNKNOWN;
   bool isMedalSession = false;
+  char sportCode[kSportCodeLen + 1] = {};
+  char sportName[kSportNameLen + 1] = {};
+  char title[kEventTitleLen + 1] = {};
+};
+
+// What one merge changed in a schedule page. Row masks are indexed by position
+// in the merged page; `redraw` also covers positions that became empty.
+struct ScheduleChanges {
+  uint64_t added = 0;
+  uint64_t statusChanged = 0;
+  uint64_t timeChanged = 0;
+  uint64_t redraw = 0;
+  uint8_t removed = 0;
+  // The page was replaced (new day, new page or first load); redraw it all.
+  bool reset = false;
+
+  bool any() const { return reset || redraw != 0 || removed != 0; }
 };
 
+static_assert(kMaxScheduleRows <= 64, "ScheduleChanges masks hold one bit per row");
+
+// One page of a day's schedule: rows [firstRow, firstRow + rowCount) of the
+// day's totalRows, sorted by start time, then event id.
 struct DailyScheduleState {
   bool valid = false;
-  String dateYmd;
+  char dateYmd[11] = {};
   uint8_t rowCount = 0;
+  uint16_t firstRow = 0;
+  uint16_t totalRows = 0;
   CompetitionRow rows[kMaxScheduleRows];
+  // Next medal session from now, looked up across the cached days.
+  bool hasNextMedal = false;
+  CompetitionRow nextMedal;
+  // Bumped by every change; `changes` takes revision - 1 to revision, so a
+  // reader that skipped a revision must redraw everything.
+  uint32_t revision = 0;
+  ScheduleChanges changes;
 };
 
 struct MedalAlertEvent {
   bool valid = false;
   MedalType medalType = MedalType::UNKNOWN;
   uint8_t delta = 0;
-  String sportCode;
-  String sportName;
+  char countryCode[kNocCodeLen + 1] = {};
+  char countryName[kCountryNameLen + 1] = {};
+  char sportCode[kSportCodeLen + 1] = {};
+  char sportName[kSportNameLen + 1] = {};
+};
+
+static_assert(std::is_trivially_copyable<MedalTableState>::value, "MedalTableState must stay plain data");
+static_assert(std::is_trivially_copyable<DailyScheduleState>::value, "DailyScheduleState must stay plain data");
+static_assert(std::is_trivially_copyable<MedalAlertEvent>::value, "MedalAlertEvent must stay plain data");
+static_assert(std::is_trivially_copyable<MedalChangeEvent>::value, "MedalChangeEvent must stay plain data");
+
+// Flag image URLs follow a fixed pattern, so they are derived from the NOC
+// code on demand instead of being stored per row.
+String medalFlagUrl(const char *countryCode);
+
+// Merges a freshly fetched page into `live` by event id, rewriting only rows
+// that differ, and records what changed in live.changes. The next-medal
+// fields are left alone. Returns false if nothing changed.
+bool mergeSchedulePage(DailyScheduleState &live, const DailyScheduleState &fresh);
+
+// Consumes one HTTP response body. parse() returns false when the payload
+// could not be understood.
+class ResponseParser {
+public:
+  virtual ~ResponseParser() {}
+  virtual bool parse(Stream &body) = 0;
+  // True when parse() returned before reading the whole body.
+  virtual bool stoppedEarly() const { return false; }
+};
+
+// Receives every row of a fetched day in start-time order, including those
+// past the page kept in RAM. `rowsCrc` is crc32_le over those rows, so a sink
+// can tell an unchanged day up front. begin() returning false declines the
+// rows; end() returns false if they could not be stored.
+class ScheduleRowSink {
+public:
+  virtual ~ScheduleRowSink() {}
+  virtual bool begin(const char *dateYmd, uint16_t rowCount, uint32_t rowsCrc) = 0;
+  virtual bool write(const CompetitionRow &row) = 0;
+  virtual bool end(bool complete) = 0;
 };
 
 class OlympicScoreboardClient {
 public:
-  bool fetchMedalTable(MedalTableState &out, const String &favoriteCountryCode);
-  bool fetchDailySchedule(DailyScheduleState &out, const String &startDateYmd);
-  bool primeFavoriteSportBaseline(const String &favoriteCountryCode);
-  bool buildFavoriteMedalAlert(const MedalTableState &prev,
-                               const MedalTableState &curr,
-                               const String &favoriteCountryCode,
-                               MedalAlertEvent &out);
+  FetchResult fetchMedalTable(MedalTableState &out, const FavoriteSet &favorites);
+  // Fills `out` with the page starting at `firstRow` of the day's rows sorted
+  // by start time, and streams all of them to `sink` when one is given.
+  FetchResult fetchDailySchedule(DailyScheduleState &out,
+                                 const String &startDateYmd,
+                                 ScheduleRowSink *sink = nullptr,
+                                 uint16_t firstRow = 0);
+  // Restores each favourite's per-sport baseline saved in NVS by a previous
+  // boot, if it belongs to this competition. Call before the first poll.
+  void loadSportBaseline(const FavoriteSet &favorites);
+  // Reconciles the per-sport baselines with the first medal table after boot.
+  // A persisted baseline whose table totals still match costs no requests;
+  // medals won while the device was down are attributed and written to
+  // `missed` (their count to `missedCount`); anything else falls back to a
+  // full sweep, shared by every favourite that needs one.
+  bool syncSportBaseline(const MedalTableState &curr,
+                         const DailyScheduleState &schedule,
+                         const FavoriteSet &favorites,
+                         MedalAlertEvent *missed,
+                         uint8_t maxMissed,
+                         uint8_t &missedCount);
+  // Attributes the favourites' medal gains in `changes` to sports, querying
+  // the sports with recent medal sessions in `schedule` first and sweeping the
+  // rest only when those do not explain the gains. Each sport is fetched once
+  // for all favourites. Writes one alert per favourite, colour and sport, up
+  // to `maxOut`, and returns how many.
+  uint8_t buildFavoriteMedalAlerts(const MedalChangeEvent *changes,
+                                   uint8_t changeCount,
+                                   const MedalTableState &curr,
+                                   const DailyScheduleState &schedule,
+                                   const FavoriteSet &favorites,
+                                   MedalAlertEvent *out,
+                                   uint8_t maxOut);
 
 private:
   struct SportMedalCounts {
@@ -79,18 +235,94 @@ private:
     uint16_t bronze = 0;
   };
 
-  bool httpGetJson(const String &url,
-                   ArduinoJson::JsonDocument &doc,
-                   const ArduinoJson::JsonDocument *filter = nullptr,
-                   bool useMedalsAuth = false);
-  bool fetchFavoriteSportCounts(const String &favoriteCountryCode,
-                                SportMedalCounts *outCounts,
-                                uint8_t count);
-  bool fetchFavoriteSportCountsOne(const String &favoriteCountryCode,
-                                   const char *sportCode,
-                                   SportMedalCounts &outCounts);
-  void sortScheduleRows(DailyScheduleState &schedule);
-
-  bool _sportBaselineValid = false;
-  SportMedalCounts _sportBaseline[kWinterSportCount];
+  // NVS image of one favourite's sport baseline, stamped with its medal
+  // table totals at the time it was taken.
+  struct PersistedSportBaseline {
+    uint16_t version;
+    char competition[8];
+    char country[kNocCodeLen + 1];
+    uint32_t savedEpoch;
+    uint16_t tableGold;
+    uint16_t tableSilver;
+    uint16_t tableBronze;
+    SportMedalCounts counts[kWinterSportCount];
+  };
+
+  // Running result of one attribution pass across the queried sports, per
+  // favourite taking part.
+  struct SportAttribution {
+    bool involved[kMaxFavorites] = {};
+    int explained[kMaxFavorites][3] = {};
+    // Medals gained per sport, indexed by MedalType.
+    uint8_t gained[kMaxFavorites][kWinterSportCount][3] = {};
+    bool queried[kWinterSportCount] = {};
+  };
+
+  // Per-URL validators for conditional GETs plus a hash of the last body so
+  // unchanged payloads are detected even when the server ignores them.
+  struct CachedValidators {
+    uint32_t urlHash = 0;
+    uint32_t bodyHash = 0;
+    uint32_t lastUsedMs = 0;
+    String etag;
+    String lastModified;
+  };
+
+  static const uint8_t kValidatorSlots = 6;
+
+  enum class Endpoint : uint8_t {
+    MEDALS_COUNTRY,
+    MEDALS_SPORT,
+    SCHEDULE,
+    COUNT
+  };
+
+  enum class BreakerState : uint8_t {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+  // Failure tracking for one upstream endpoint. Each failure pushes the next
+  // allowed request out by a jittered exponential backoff; repeated failures
+  // open the breaker, after which a single probe decides whether it closes.
+  struct EndpointHealth {
+    BreakerState state = BreakerState::CLOSED;
+    uint8_t failures = 0;
+    uint32_t retryAtMs = 0;
+  };
+
+  enum class ScheduleDateFormat : uint8_t {
+    UNKNOWN,
+    DASHED,
+    COMPACT
+  };
+
+  FetchResult httpGet(Endpoint endpoint,
+                      const String &url,
+                      ResponseParser &parser,
+                      bool useMedalsAuth = false,
+                      bool conditional = false);
+  bool endpointAllowed(Endpoint endpoint);
+  void recordEndpointSuccess(Endpoint endpoint);
+  void recordEndpointFailure(Endpoint endpoint, uint32_t retryAfterMs);
+  CachedValidators *validatorsFor(uint32_t urlHash, bool create);
+  void forgetValidators(const String &url);
+  // One medals-by-sport request fills the counts of every favourite.
+  bool fetchSportCounts(const FavoriteSet &favorites,
+                        const char *sportCode,
+                        SportMedalCounts (&outCounts)[kMaxFavorites]);
+  bool primeFavoriteSportBaseline(const MedalTableState &curr, const FavoriteSet &favorites, const bool *which);
+  void saveSportBaseline(const MedalTableState &curr, const FavoriteSet &favorites, uint8_t fav);
+  uint8_t rankCandidateSports(const DailyScheduleState &schedule, uint8_t *out, uint8_t maxOut) const;
+  void attributeSport(const FavoriteSet &favorites, uint8_t sportIdx, SportAttribution &acc);
+
+  CachedValidators _validators[kValidatorSlots];
+  EndpointHealth _health[(uint8_t)Endpoint::COUNT];
+  int _lastHttpCode = 0;
+  ScheduleDateFormat _scheduleDateFormat = ScheduleDateFormat::UNKNOWN;
+  bool _sportBaselineValid[kMaxFavorites] = {};
+  SportMedalCounts _sportBaseline[kMaxFavorites][kWinterSportCount];
+  bool _persistedBaselineValid[kMaxFavorites] = {};
+  SportMedalCounts _persistedTotals[kMaxFavorites];
 };
@@ -8,6 +8,35 @@
 
 namespace {
 
+// Medal table layout; rows start at kMedalRowTop.
+static const int16_t kMedalRowTop = 40;
+static const int16_t kMedalRowH = 26;
+static const int16_t kMedalFooterH = 20;
+static const int16_t kMedalXRank = 8;
+static const int16_t kMedalXFlag = 26;
+static const int16_t kMedalXCountry = 70;
+static const int16_t kMedalXGold = 236;
+static const int16_t kMedalXSilver = 264;
+static const int16_t kMedalXBronze = 290;
+static const int16_t kMedalXTotal = 316;
+// Right-aligned count cells span [x - kMedalNumW, x).
+static const int16_t kMedalNumW = 24;
+
+// Schedule row layout; rows are centred on rowTop + i * rowH.
+static const int16_t kScheduleRowTop = 42;
+static const int16_t kScheduleRowH = 19;
+static const int16_t kScheduleFooterH = 20;
+static const int16_t kScheduleXSport = 68;
+static const int16_t kScheduleXDot = 108;
+static const int16_t kScheduleXTitle = 116;
+
+// Everything between the column headings and the footer.
+static const int16_t kBodyTop = 35;
+
+static int16_t scheduleRowSlots(int16_t screenH) {
+  return (int16_t)((screenH - kScheduleRowTop - kScheduleFooterH - 2) / kScheduleRowH);
+}
+
 static inline void drawCentered(TFT_eSPI &tft,
                                 const String &text,
                                 int16_t x,
@@ -57,6 +86,7 @@ void OlympicScoreboardUi::setRotation(uint8_t rotation) {
   _tft->setRotation(_rotation);
   _tft->resetViewport();
   _tft->fillScreen(Palette::BG);
+  _shown = Page::NONE;
 }
 
 void OlympicScoreboardUi::setBacklight(uint8_t pct) {
@@ -69,6 +99,7 @@ void OlympicScoreboardUi::clearScreen() {
   _tft->resetViewport();
   _tft->fillScreen(Palette::BG);
   _tft->drawRect(0, 0, _tft->width(), _tft->height(), Palette::FRAME);
+  _shown = Page::NONE;
 }
 
 String OlympicScoreboardUi::formatClock(time_t epoch) const {
@@ -123,167 +154,293 @@ void OlympicScoreboardUi::drawBootSplash(const String &line1, const String &line
   }
 }
 
-void OlympicScoreboardUi::drawMedals(const MedalTableState &medals,
-                                     const String &favoriteCountryCode,
-                                     bool wifiConnected,
-                                     bool stale) {
-  if (!_tft) return;
+bool OlympicScoreboardUi::beginPage(Page page) {
+  if (_shown == page) return false;
   clearScreen();
+  _shown = page;
+  _bodyKey = "";
+  _footerLeft = "";
+  _footerRight = "";
+  for (uint8_t i = 0; i < kMaxRowSlots; ++i) {
+    _medalSlots[i].used = false;
+    _scheduleSlots[i].used = false;
+  }
+  return true;
+}
 
+bool OlympicScoreboardUi::setBody(const String &key) {
+  if (key == _bodyKey) return false;
   const int16_t w = _tft->width();
   const int16_t h = _tft->height();
+  _tft->fillRect(1, kBodyTop, w - 2, h - 18 - kBodyTop, Palette::BG);
+  for (uint8_t i = 0; i < kMaxRowSlots; ++i) {
+    _medalSlots[i].used = false;
+    _scheduleSlots[i].used = false;
+  }
+  _bodyKey = key;
+  return true;
+}
 
-  _tft->fillRect(1, 1, w - 2, 22, Palette::PANEL_2);
-  drawCentered(*_tft, "MEDAL STANDINGS", w / 2, 12, 2, Palette::WHITE, Palette::PANEL_2);
-
-  const int16_t xRank = 8;
-  const int16_t xFlag = 26;
-  const int16_t xCountry = 70;
-  const int16_t xGold = 236;
-  const int16_t xSilver = 264;
-  const int16_t xBronze = 290;
-  const int16_t xTotal = 316;
-
+void OlympicScoreboardUi::drawFooter(const String &left, const String &right) {
+  if (left == _footerLeft && right == _footerRight) return;
+  const int16_t w = _tft->width();
+  const int16_t h = _tft->height();
+  _tft->fillRect(1, h - 18, w - 2, 17, Palette::PANEL);
   _tft->setTextFont(1);
-  _tft->setTextColor(Palette::GREY, Palette::BG);
   _tft->setTextDatum(ML_DATUM);
-  _tft->drawString("#", xRank, 30);
-  _tft->drawString("COUNTRY", xCountry, 30);
+  _tft->setTextColor(Palette::GREY, Palette::PANEL);
+  _tft->drawString(left, 6, h - 9);
   _tft->setTextDatum(MR_DATUM);
-  _tft->drawString("G", xGold, 30);
-  _tft->drawString("S", xSilver, 30);
-  _tft->drawString("B", xBronze, 30);
-  _tft->drawString("T", xTotal, 30);
+  _tft->drawString(right, w - 6, h - 9);
+  _footerLeft = left;
+  _footerRight = right;
+}
+
+void OlympicScoreboardUi::drawMedals(const MedalTableState &medals,
+                                     const FavoriteSet &favorites,
+                                     bool wifiConnected,
+                                     bool stale) {
+  if (!_tft) return;
+
+  const int16_t w = _tft->width();
+  const int16_t h = _tft->height();
+
+  const uint32_t flagGeneration = Assets::flagGeneration();
+  _flagsLanded = flagGeneration != _flagGeneration;
+  _flagGeneration = flagGeneration;
+
+  if (beginPage(Page::MEDALS)) {
+    _tft->fillRect(1, 1, w - 2, 22, Palette::PANEL_2);
+    drawCentered(*_tft, "MEDAL STANDINGS", w / 2, 12, 2, Palette::WHITE, Palette::PANEL_2);
+
+    _tft->setTextFont(1);
+    _tft->setTextColor(Palette::GREY, Palette::BG);
+    _tft->setTextDatum(ML_DATUM);
+    _tft->drawString("#", kMedalXRank, 30);
+    _tft->drawString("COUNTRY", kMedalXCountry, 30);
+    _tft->setTextDatum(MR_DATUM);
+    _tft->drawString("G", kMedalXGold, 30);
+    _tft->drawString("S", kMedalXSilver, 30);
+    _tft->drawString("B", kMedalXBronze, 30);
+    _tft->drawString("T", kMedalXTotal, 30);
+  }
 
   if (!medals.valid || medals.rowCount == 0) {
-    drawCentered(*_tft, "Waiting for medals feed...", w / 2, h / 2, 2, Palette::WHITE, Palette::BG);
+    if (setBody("waiting")) {
+      drawCentered(*_tft, "Waiting for medals feed...", w / 2, h / 2, 2, Palette::WHITE, Palette::BG);
+    }
   } else {
-    String fav = favoriteCountryCode;
-    fav.toUpperCase();
-    const int16_t rowTop = 40;
-    const int16_t rowH = 26;
-    const int16_t footerH = 20;
-    const int16_t maxRows = (h - rowTop - footerH - 2) / rowH;
-    const int16_t rowsToDraw = min((int16_t)medals.rowCount, maxRows);
-    bool favoriteDrawn = false;
-
-    for (int16_t i = 0; i < rowsToDraw; ++i) {
-      const MedalRow &row = medals.rows[i];
-      const int16_t y = rowTop + i * rowH;
-      const bool isFavorite = row.countryCode == fav;
-      if (isFavorite) {
-        _tft->fillRect(4, y, w - 8, rowH - 1, Palette::PANEL_2);
-        favoriteDrawn = true;
+    setBody("");
+    const int16_t maxRows =
+        min((int16_t)((h - kMedalRowTop - kMedalFooterH - 2) / kMedalRowH), (int16_t)kMaxRowSlots);
+
+    // Favourites below the visible rows are pinned to the bottom slots, each
+    // taking a slot from the table; repeat until no favourite is pushed off.
+    uint8_t pinned[kMaxFavorites];
+    uint8_t pinnedCount = 0;
+    int16_t tableRows = min((int16_t)medals.rowCount, maxRows);
+    for (uint8_t pass = 0; pass <= kMaxFavorites; ++pass) {
+      pinnedCount = 0;
+      for (uint8_t f = 0; f < favorites.count(); ++f) {
+        const int8_t index = (f < medals.favoriteCount) ? medals.favorites[f].index : -1;
+        if (index < 0 || index >= tableRows) pinned[pinnedCount++] = f;
       }
-      _tft->drawFastHLine(4, (int16_t)(y + rowH - 1), w - 8, Palette::PANEL);
-
-      _tft->setTextColor(isFavorite ? Palette::WHITE : Palette::GREY, isFavorite ? Palette::PANEL_2 : Palette::BG);
-      _tft->setTextFont(1);
-      _tft->setTextDatum(ML_DATUM);
-      _tft->drawString(String(row.rank), xRank, (int16_t)(y + rowH / 2));
-
-      const int16_t flagSize = 12;
-      const int16_t flagY = (int16_t)(y + rowH / 2 - flagSize / 2);
-      const String flagUrl = row.flagUrlSmall.length() ? row.flagUrlSmall : row.flagUrlMedium;
-      Assets::drawLogo(*_tft, row.countryCode, flagUrl, xFlag, flagY, flagSize);
-
-      _tft->drawString(elideToWidth(row.countryName, 156, 2), xCountry, (int16_t)(y + rowH / 2));
-      _tft->setTextDatum(MR_DATUM);
-      _tft->drawString(String(row.gold), xGold, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(row.silver), xSilver, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(row.bronze), xBronze, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(row.total), xTotal, (int16_t)(y + rowH / 2));
+      const int16_t fit = max((int16_t)0, min((int16_t)medals.rowCount, (int16_t)(maxRows - pinnedCount)));
+      if (fit == tableRows) break;
+      tableRows = fit;
     }
 
-    if (!favoriteDrawn) {
-      const int16_t y = h - 40;
-      _tft->fillRect(4, y, w - 8, rowH - 1, Palette::PANEL_2);
-      _tft->drawFastHLine(4, (int16_t)(y + rowH - 1), w - 8, Palette::PANEL);
-      _tft->setTextColor(Palette::WHITE, Palette::PANEL_2);
-      _tft->setTextFont(1);
-      _tft->setTextDatum(ML_DATUM);
-      _tft->drawString("CAN", xRank, (int16_t)(y + rowH / 2));
-      Assets::drawLogo(*_tft, "CAN", "https://images.nbcolympics.com/country-flags/38x25/can.png", xFlag, (int16_t)(y + rowH / 2 - 6), 12);
-      _tft->drawString("Canada", xCountry, (int16_t)(y + rowH / 2));
-      _tft->setTextDatum(MR_DATUM);
-      _tft->drawString(String(medals.favoriteGold), xGold, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(medals.favoriteSilver), xSilver, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(medals.favoriteBronze), xBronze, (int16_t)(y + rowH / 2));
-      _tft->drawString(String(medals.favoriteTotal), xTotal, (int16_t)(y + rowH / 2));
+    for (int16_t i = 0; i < maxRows; ++i) {
+      if (i < tableRows) {
+        const MedalRow &row = medals.rows[i];
+        updateMedalSlot(i, &row, favorites.indexOf(row.countryCode) >= 0);
+        continue;
+      }
+      if (i - tableRows >= pinnedCount) {
+        updateMedalSlot(i, nullptr, false);
+        continue;
+      }
+      const uint8_t f = pinned[i - tableRows];
+      MedalRow row;
+      const FavoriteStanding *standing = (f < medals.favoriteCount) ? &medals.favorites[f] : nullptr;
+      if (standing && standing->present && strcmp(standing->row.countryCode, favorites.code(f)) == 0) {
+        row = standing->row;
+      } else {
+        // Not in the feed yet: no medals.
+        strlcpy(row.countryCode, favorites.code(f), sizeof(row.countryCode));
+        strlcpy(row.countryName, favorites.code(f), sizeof(row.countryName));
+      }
+      updateMedalSlot(i, &row, true);
     }
   }
 
-  _tft->fillRect(1, h - 18, w - 2, 17, Palette::PANEL);
-  _tft->setTextFont(1);
-  _tft->setTextDatum(ML_DATUM);
-  _tft->setTextColor(Palette::GREY, Palette::PANEL);
   String left = wifiConnected ? "ONLINE" : "OFFLINE";
   if (stale) left += " | STALE";
-  _tft->drawString(left, 6, h - 9);
+  String right;
+  for (uint8_t f = 0; f < favorites.count(); ++f) {
+    right += favorites.code(f);
+    right += ' ';
+  }
+  right += "HIGHLIGHT";
+  drawFooter(left, right);
+}
+
+void OlympicScoreboardUi::updateMedalSlot(uint8_t slot, const MedalRow *row, bool highlight) {
+  MedalSlot &shown = _medalSlots[slot];
+  const int16_t w = _tft->width();
+  const int16_t y = kMedalRowTop + slot * kMedalRowH;
+  if (!row) {
+    if (shown.used) _tft->fillRect(4, y, w - 8, kMedalRowH, Palette::BG);
+    shown.used = false;
+    return;
+  }
+
+  const MedalRow &prev = shown.row;
+  const bool whole = !shown.used || shown.highlight != highlight;
+  const uint16_t bg = highlight ? Palette::PANEL_2 : Palette::BG;
+  const int16_t cy = (int16_t)(y + kMedalRowH / 2);
+  const int16_t cellH = kMedalRowH - 1;
+  if (whole) {
+    if (highlight || shown.used) _tft->fillRect(4, y, w - 8, cellH, bg);
+    _tft->drawFastHLine(4, (int16_t)(y + cellH), w - 8, Palette::PANEL);
+  }
+
+  _tft->setTextColor(highlight ? Palette::WHITE : Palette::GREY, bg);
+  _tft->setTextFont(1);
+  _tft->setTextDatum(ML_DATUM);
+  if (whole || prev.rank != row->rank) {
+    if (!whole) _tft->fillRect(4, y, kMedalXFlag - 5, cellH, bg);
+    _tft->drawString(row->rank ? String(row->rank) : String("-"), kMedalXRank, cy);
+  }
+
+  const bool country =
+      whole || strcmp(prev.countryCode, row->countryCode) != 0 || strcmp(prev.countryName, row->countryName) != 0;
+  if (country && !whole) {
+    const int16_t countryRight = kMedalXGold - kMedalNumW;
+    _tft->fillRect(kMedalXFlag - 1, y, countryRight - kMedalXFlag + 1, cellH, bg);
+  }
+  // A badge is redrawn alone once the prefetcher may have landed its flag.
+  if (country || (_flagsLanded && !shown.flagShown)) {
+    shown.flagShown = Assets::drawLogo(*_tft,
+                                       row->countryCode,
+                                       medalFlagUrl(row->countryCode),
+                                       kMedalXFlag,
+                                       cy - kTableFlagSize / 2,
+                                       kTableFlagSize);
+  }
+  if (country) _tft->drawString(elideToWidth(row->countryName, 156, 2), kMedalXCountry, cy);
+
   _tft->setTextDatum(MR_DATUM);
-  _tft->drawString("CAN HIGHLIGHT", w - 6, h - 9);
+  const uint16_t values[] = {row->gold, row->silver, row->bronze, row->total};
+  const uint16_t before[] = {prev.gold, prev.silver, prev.bronze, prev.total};
+  const int16_t right[] = {kMedalXGold, kMedalXSilver, kMedalXBronze, kMedalXTotal};
+  for (uint8_t c = 0; c < 4; ++c) {
+    if (!whole && values[c] == before[c]) continue;
+    if (!whole) _tft->fillRect(right[c] - kMedalNumW, y, kMedalNumW, cellH, bg);
+    _tft->drawString(String(values[c]), right[c], cy);
+  }
+
+  shown.used = true;
+  shown.highlight = highlight;
+  shown.row = *row;
 }
 
 void OlympicScoreboardUi::drawSchedule(const DailyScheduleState &schedule,
                                        bool wifiConnected,
                                        bool stale) {
   if (!_tft) return;
-  clearScreen();
 
   const int16_t w = _tft->width();
   const int16_t h = _tft->height();
 
-  _tft->fillRect(1, 1, w - 2, 22, Palette::PANEL_2);
-  drawCentered(*_tft, "TODAY'S COMPETITIONS", w / 2, 12, 2, Palette::WHITE, Palette::PANEL_2);
+  if (beginPage(Page::SCHEDULE)) {
+    _tft->fillRect(1, 1, w - 2, 22, Palette::PANEL_2);
+    drawCentered(*_tft, "TODAY'S COMPETITIONS", w / 2, 12, 2, Palette::WHITE, Palette::PANEL_2);
 
-  _tft->setTextFont(1);
-  _tft->setTextColor(Palette::GREY, Palette::BG);
-  _tft->setTextDatum(ML_DATUM);
-  _tft->drawString("TIME", 8, 30);
-  _tft->drawString("SPORT", 68, 30);
-  _tft->drawString("EVENT", 116, 30);
+    _tft->setTextFont(1);
+    _tft->setTextColor(Palette::GREY, Palette::BG);
+    _tft->setTextDatum(ML_DATUM);
+    _tft->drawString("TIME", 8, 30);
+    _tft->drawString("SPORT", kScheduleXSport, 30);
+    _tft->drawString("EVENT", kScheduleXTitle, 30);
+  }
 
-  if (!schedule.valid || schedule.rowCount == 0) {
-    drawCentered(*_tft, "Waiting for schedule feed...", w / 2, h / 2, 2, Palette::WHITE, Palette::BG);
-  } else {
-    const int16_t rowTop = 42;
-    const int16_t rowH = 19;
-    const int16_t footerH = 20;
-    const int16_t rowsToDraw = min((int16_t)schedule.rowCount, (int16_t)((h - rowTop - footerH - 2) / rowH));
-
-    for (int16_t i = 0; i < rowsToDraw; ++i) {
-      const CompetitionRow &row = schedule.rows[i];
-      const int16_t y = rowTop + i * rowH;
-      const bool isLive = row.status.equalsIgnoreCase("live");
-      const uint16_t bg = isLive ? Palette::PANEL_2 : Palette::BG;
-      const uint16_t fg = isLive ? Palette::WHITE : Palette::GREY;
-      if (isLive) _tft->fillRect(4, y - 7, w - 8, rowH - 1, bg);
-
-      _tft->setTextFont(1);
-      _tft->setTextDatum(ML_DATUM);
-      _tft->setTextColor(fg, bg);
-      _tft->drawString(formatClock(row.startEpoch), 8, y);
-      _tft->drawString(row.sportCode, 68, y);
-      _tft->drawString(elideToWidth(row.title, w - 122, 1), 116, y);
-
-      if (row.isMedalSession) {
-        _tft->fillCircle(108, y, 3, Palette::GOLD);
+  if (!schedule.valid) {
+    if (setBody("waiting")) {
+      drawCentered(*_tft, "Waiting for schedule feed...", w / 2, h / 2, 2, Palette::WHITE, Palette::BG);
+    }
+  } else if (schedule.rowCount == 0) {
+    const CompetitionRow &next = schedule.nextMedal;
+    const String when = formatDate(next.startEpoch) + " " + formatClock(next.startEpoch);
+    String key = "none";
+    if (schedule.hasNextMedal) key += when + next.sportCode + next.title;
+    if (setBody(key)) {
+      drawCentered(*_tft, "No events today", w / 2, h / 2 - 24, 2, Palette::WHITE, Palette::BG);
+      if (schedule.hasNextMedal) {
+        drawCentered(*_tft, "NEXT MEDAL EVENT", w / 2, h / 2 + 4, 1, Palette::GOLD, Palette::BG);
+        drawCentered(*_tft, when + "  " + next.sportCode, w / 2, h / 2 + 20, 2, Palette::WHITE, Palette::BG);
+        drawCentered(*_tft, elideToWidth(next.title, w - 16, 1), w / 2, h / 2 + 38, 1, Palette::GREY, Palette::BG);
       }
     }
+  } else {
+    setBody("");
+    const int16_t slots = min(scheduleRowSlots(h), (int16_t)kMaxRowSlots);
+    for (int16_t i = 0; i < slots; ++i) {
+      updateScheduleSlot(i, i < schedule.rowCount ? &schedule.rows[i] : nullptr);
+    }
   }
 
-  _tft->fillRect(1, h - 18, w - 2, 17, Palette::PANEL);
-  _tft->setTextFont(1);
-  _tft->setTextDatum(ML_DATUM);
-  _tft->setTextColor(Palette::GREY, Palette::PANEL);
   String left = wifiConnected ? "ONLINE" : "OFFLINE";
   if (stale) left += " | STALE";
-  _tft->drawString(left, 6, h - 9);
-  _tft->setTextDatum(MR_DATUM);
-  _tft->drawString(schedule.dateYmd, w - 6, h - 9);
+  drawFooter(left, schedule.dateYmd);
+}
+
+void OlympicScoreboardUi::updateScheduleSlot(uint8_t slot, const CompetitionRow *row) {
+  ScheduleSlot &shown = _scheduleSlots[slot];
+  const int16_t w = _tft->width();
+  const int16_t y = kScheduleRowTop + slot * kScheduleRowH;
+  const int16_t top = y - 7;
+  const int16_t cellH = kScheduleRowH - 1;
+  if (!row) {
+    if (shown.used) _tft->fillRect(4, top, w - 8, cellH, Palette::BG);
+    shown.used = false;
+    return;
+  }
+
+  const CompetitionRow &prev = shown.row;
+  const bool isLive = row->status == EventStatus::LIVE;
+  const bool whole = !shown.used || (prev.status == EventStatus::LIVE) != isLive;
+  const uint16_t bg = isLive ? Palette::PANEL_2 : Palette::BG;
+  const uint16_t fg = isLive ? Palette::WHITE : Palette::GREY;
+  if (whole) _tft->fillRect(4, top, w - 8, cellH, bg);
+
+  _tft->setTextFont(1);
+  _tft->setTextDatum(ML_DATUM);
+  _tft->setTextColor(fg, bg);
+  if (whole || prev.startEpoch != row->startEpoch) {
+    if (!whole) _tft->fillRect(4, top, kScheduleXSport - 6, cellH, bg);
+    _tft->drawString(formatClock(row->startEpoch), 8, y);
+  }
+  // A long sport code can run into the medal dot, so the dot follows it.
+  const bool sportDirty = whole || strcmp(prev.sportCode, row->sportCode) != 0;
+  if (sportDirty) {
+    if (!whole) _tft->fillRect(kScheduleXSport - 2, top, kScheduleXDot - 4 - kScheduleXSport + 2, cellH, bg);
+    _tft->drawString(row->sportCode, kScheduleXSport, y);
+  }
+  if (sportDirty || prev.isMedalSession != row->isMedalSession) {
+    if (!whole) _tft->fillRect(kScheduleXDot - 4, top, 9, cellH, bg);
+    if (row->isMedalSession) _tft->fillCircle(kScheduleXDot, y, 3, Palette::GOLD);
+  }
+  if (whole || strcmp(prev.title, row->title) != 0) {
+    if (!whole) _tft->fillRect(kScheduleXTitle - 3, top, w - 4 - kScheduleXTitle + 3, cellH, bg);
+    _tft->drawString(elideToWidth(row->title, w - 122, 1), kScheduleXTitle, y);
+  }
+
+  shown.used = true;
+  shown.row = *row;
 }
 
-void OlympicScoreboardUi::drawMedalAlert(const MedalAlertEvent &alert, const String &favoriteCountryCode) {
+void OlympicScoreboardUi::drawMedalAlert(const MedalAlertEvent &alert) {
   if (!_tft) return;
   clearScreen();
 
@@ -292,7 +449,9 @@ void OlympicScoreboardUi::drawMedalAlert(const MedalAlertEvent &alert, const Str
   const uint16_t medalCol = medalColor(alert.medalType);
 
   _tft->fillRect(1, 1, w - 2, 26, Palette::PANEL_2);
-  drawCentered(*_tft, "CANADA MEDAL ALERT", w / 2, 13, 2, Palette::WHITE, Palette::PANEL_2);
+  String title = alert.countryName[0] ? alert.countryName : alert.countryCode;
+  title.toUpperCase();
+  drawCentered(*_tft, elideToWidth(title + " MEDAL ALERT", w - 12, 2), w / 2, 13, 2, Palette::WHITE, Palette::PANEL_2);
 
   const int16_t medalCx = 94;
   const int16_t medalCy = 116;
@@ -311,10 +470,10 @@ void OlympicScoreboardUi::drawMedalAlert(const MedalAlertEvent &alert, const Str
     _tft->drawString("+1", medalCx, medalCy + 14);
   }
 
-  Assets::drawLogo(*_tft, favoriteCountryCode, 190, 78, 72);
+  Assets::drawLogo(*_tft, alert.countryCode, 190, 78, 72);
   _tft->setTextColor(Palette::WHITE, Palette::BG);
   _tft->setTextFont(2);
-  _tft->drawString("CAN", 226, 160);
+  _tft->drawString(alert.countryCode, 226, 160);
   _tft->setTextColor(Palette::GREY, Palette::BG);
   _tft->drawString(elideToWidth(alert.sportName, w - 16, 2), w / 2, 198);
 }
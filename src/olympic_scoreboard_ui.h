@@ -4,27 +4,73 @@
 
 #include "olympic_scoreboard_client.h"
 
+// The medals and schedule pages keep a model of what each row slot and the
+// footer show. Drawing the page that is already on screen repaints only the
+// cells whose value changed; any other draw, an alert or a rotation makes the
+// next page draw a full paint.
 class OlympicScoreboardUi {
 public:
+  // Flag size in medal table rows; what the prefetcher fetches for them.
+  static const int16_t kTableFlagSize = 12;
+
   void begin(TFT_eSPI &tft, uint8_t rotation);
   void setRotation(uint8_t rotation);
   void setBacklight(uint8_t pct);
 
   void drawBootSplash(const String &line1, const String &line2);
   void drawMedals(const MedalTableState &medals,
-                  const String &favoriteCountryCode,
+                  const FavoriteSet &favorites,
                   bool wifiConnected,
                   bool stale);
   void drawSchedule(const DailyScheduleState &schedule,
                     bool wifiConnected,
                     bool stale);
-  void drawMedalAlert(const MedalAlertEvent &alert, const String &favoriteCountryCode);
+  void drawMedalAlert(const MedalAlertEvent &alert);
 
 private:
+  enum class Page : uint8_t {
+    NONE,
+    MEDALS,
+    SCHEDULE
+  };
+
+  static const uint8_t kMaxRowSlots = 16;
+
+  struct MedalSlot {
+    bool used = false;
+    bool highlight = false;
+    // False while the fallback badge stands in for the flag.
+    bool flagShown = false;
+    MedalRow row;
+  };
+
+  struct ScheduleSlot {
+    bool used = false;
+    CompetitionRow row;
+  };
+
   TFT_eSPI *_tft = nullptr;
   uint8_t _rotation = 1;
 
+  Page _shown = Page::NONE;
+  // What fills the area between header and footer when it is not rows, e.g.
+  // the waiting message; empty while rows are shown.
+  String _bodyKey;
+  String _footerLeft;
+  String _footerRight;
+  MedalSlot _medalSlots[kMaxRowSlots];
+  ScheduleSlot _scheduleSlots[kMaxRowSlots];
+  // Assets::flagGeneration() at the last medals draw; when it moves, slots
+  // still showing a badge redraw just the flag.
+  uint32_t _flagGeneration = 0;
+  bool _flagsLanded = false;
+
   void clearScreen();
+  bool beginPage(Page page);
+  bool setBody(const String &key);
+  void drawFooter(const String &left, const String &right);
+  void updateMedalSlot(uint8_t slot, const MedalRow *row, bool highlight);
+  void updateScheduleSlot(uint8_t slot, const CompetitionRow *row);
   String formatClock(time_t epoch) const;
   String formatDate(time_t epoch) const;
   String elideToWidth(const String &s, int maxPx, int font) const;
@@ -0,0 +1,121 @@
+#include "poll_scheduler.h"
+
+#include "config.h"
+
+namespace {
+
+static const uint32_t kMedalsHotMs = 15000;
+static const uint32_t kMedalsWarmMs = 30000;
+static const uint32_t kMedalsSoonMs = 60000;
+static const uint32_t kMedalsIdleMs = 5UL * 60UL * 1000UL;
+
+static const uint32_t kScheduleActiveMs = 60000;
+static const uint32_t kScheduleIdleMs = 5UL * 60UL * 1000UL;
+static const uint32_t kScheduleDoneMs = 30UL * 60UL * 1000UL;
+
+// A medal session that started this long ago may still be running (or its
+// result may still be landing in the medal table).
+static const time_t kMedalSessionSpanSec = 3 * 3600;
+static const time_t kMedalSessionLeadSec = 3600;
+static const time_t kMedalFinalHotSec = 15 * 60;
+static const time_t kEventLeadSec = 30 * 60;
+
+static uint32_t requestsPerHour(uint32_t intervalMs) {
+  return intervalMs ? (uint32_t)(3600000UL / intervalMs) : 0;
+}
+
+}  // namespace
+
+void PollScheduler::update(const DailyScheduleState &schedule, time_t now, const String &todayYmd) {
+  const uint32_t prevMedals = _medalsMs;
+  const uint32_t prevSchedule = _scheduleMs;
+  plan(schedule, now, todayYmd);
+  if (_medalsMs == prevMedals && _scheduleMs == prevSchedule) return;
+
+  Serial.printf("POLL: medals %lus (%s), schedule %lus (%s) ~%lu req/h vs %lu fixed\n",
+                (unsigned long)(_medalsMs / 1000),
+                _medalsReason,
+                (unsigned long)(_scheduleMs / 1000),
+                _scheduleReason,
+                (unsigned long)(requestsPerHour(_medalsMs) + requestsPerHour(_scheduleMs)),
+                (unsigned long)(requestsPerHour(kDefaultMedalsIntervalMs) +
+                                requestsPerHour(kDefaultScheduleIntervalMs)));
+}
+
+void PollScheduler::plan(const DailyScheduleState &schedule, time_t now, const String &todayYmd) {
+  const bool clockValid = now > 1577836800;
+  if (!ADAPTIVE_POLLING || !clockValid || !schedule.valid) {
+    _medalsMs = kDefaultMedalsIntervalMs;
+    _scheduleMs = kDefaultScheduleIntervalMs;
+    _medalsReason = _scheduleReason = ADAPTIVE_POLLING ? "no schedule" : "fixed";
+    return;
+  }
+
+  bool medalLive = false;
+  bool medalRecentlyFinal = false;
+  bool medalSoon = false;
+  bool anyLive = false;
+  bool anySoon = false;
+  bool allFinal = schedule.rowCount > 0;
+
+  for (uint8_t i = 0; i < schedule.rowCount; ++i) {
+    const CompetitionRow &row = schedule.rows[i];
+    const time_t sinceStart = now - row.startEpoch;
+    if (row.status != EventStatus::FINAL) allFinal = false;
+    if (row.status == EventStatus::LIVE) anyLive = true;
+    if (sinceStart < 0 && -sinceStart <= kEventLeadSec) anySoon = true;
+
+    if (!row.isMedalSession) continue;
+    if (row.status == EventStatus::LIVE) {
+      medalLive = true;
+    } else if (sinceStart >= 0 && sinceStart <= kMedalSessionSpanSec) {
+      // Started but not reported live: treat unknown status as possibly live.
+      if (row.status == EventStatus::FINAL) {
+        medalRecentlyFinal = true;
+      } else {
+        medalLive = true;
+      }
+    } else if (sinceStart < 0 && -sinceStart <= kMedalSessionLeadSec) {
+      medalSoon = true;
+    }
+  }
+
+  // The page in RAM may end before midnight; the cached days know what the
+  // next medal session is even when it is tomorrow's first event.
+  if (schedule.hasNextMedal) {
+    const time_t untilNext = schedule.nextMedal.startEpoch - now;
+    if (untilNext >= 0 && untilNext <= kMedalSessionLeadSec) medalSoon = true;
+  }
+
+  const time_t sinceFinal = now - _medalFinalAt;
+  if (medalLive) {
+    _medalsMs = kMedalsHotMs;
+    _medalsReason = "medal session live";
+  } else if (_medalFinalAt != 0 && sinceFinal >= 0 && sinceFinal <= kMedalFinalHotSec) {
+    _medalsMs = kMedalsHotMs;
+    _medalsReason = "medal session went final";
+  } else if (medalRecentlyFinal) {
+    _medalsMs = kMedalsWarmMs;
+    _medalsReason = "medal session just finished";
+  } else if (medalSoon) {
+    _medalsMs = kMedalsSoonMs;
+    _medalsReason = "medal session soon";
+  } else {
+    _medalsMs = kMedalsIdleMs;
+    _medalsReason = "no medal sessions";
+  }
+
+  if (todayYmd != schedule.dateYmd) {
+    _scheduleMs = kScheduleActiveMs;
+    _scheduleReason = "new day";
+  } else if (anyLive || anySoon) {
+    _scheduleMs = kScheduleActiveMs;
+    _scheduleReason = "events live";
+  } else if (allFinal) {
+    _scheduleMs = kScheduleDoneMs;
+    _scheduleReason = "day complete";
+  } else {
+    _scheduleMs = kScheduleIdleMs;
+    _scheduleReason = "between events";
+  }
+}
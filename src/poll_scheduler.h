@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "olympic_scoreboard_client.h"
+
+// Chooses medal and schedule poll intervals from the day's competition
+// schedule: fast around medal decisions, slow when nothing medal-relevant is
+// on, and mostly idle for the schedule feed once every event is final.
+class PollScheduler {
+public:
+  static const uint32_t kDefaultMedalsIntervalMs = 30000;
+  static const uint32_t kDefaultScheduleIntervalMs = 60000;
+
+  // Re-plans from the latest schedule; `todayYmd` is today's local date.
+  void update(const DailyScheduleState &schedule, time_t now, const String &todayYmd);
+
+  // A medal session went FINAL at `at`; its result usually reaches the medal
+  // table some minutes later, however long the session ran.
+  void noteMedalFinal(time_t at) { _medalFinalAt = at; }
+
+  uint32_t medalsIntervalMs() const { return _medalsMs; }
+  uint32_t scheduleIntervalMs() const { return _scheduleMs; }
+
+private:
+  uint32_t _medalsMs = kDefaultMedalsIntervalMs;
+  uint32_t _scheduleMs = kDefaultScheduleIntervalMs;
+  const char *_medalsReason = "";
+  const char *_scheduleReason = "";
+  time_t _medalFinalAt = 0;
+
+  void plan(const DailyScheduleState &schedule, time_t now, const String &todayYmd);
+};
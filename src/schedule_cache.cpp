@@ -0,0 +1,236 @@
+#include "schedule_cache.h"
+
+#include <SPIFFS.h>
+#include <rom/crc.h>
+
+namespace {
+
+static const uint32_t kSegmentMagic = 0x3153534F;  // "OSS1"
+static const uint16_t kSegmentVersion = 1;
+static const char *kSegmentDir = "/sched";
+
+static const uint8_t kMaxPrunePerCall = 8;
+
+struct SegmentHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t rowSize;
+  uint16_t rowCount;
+  char dateYmd[sizeof(DailyScheduleState::dateYmd)];
+  uint8_t reserved[3];
+};
+
+uint32_t g_generation = 0;
+
+// "2026-02-10" -> "/sched/20260210.bin"
+String segmentPath(const char *dateYmd) {
+  String path(kSegmentDir);
+  path += '/';
+  for (const char *p = dateYmd; *p; ++p) {
+    if (*p != '-') path += *p;
+  }
+  path += ".bin";
+  return path;
+}
+
+bool validHeader(const SegmentHeader &header, const char *dateYmd) {
+  return header.magic == kSegmentMagic && header.version == kSegmentVersion &&
+         header.rowSize == sizeof(CompetitionRow) && header.rowCount <= kMaxDayRows &&
+         strncmp(header.dateYmd, dateYmd, sizeof(header.dateYmd)) == 0;
+}
+
+// Reads the CRC trailer of a stored segment without walking its rows. Only
+// used to skip rewrites, so a corrupt segment that happens to match is still
+// caught by scanSegment().
+bool storedCrc(const String &path, const char *dateYmd, uint16_t rowCount, uint32_t &crc) {
+  if (!SPIFFS.exists(path)) return false;
+  File f = SPIFFS.open(path, "r");
+  if (!f) return false;
+  SegmentHeader header;
+  bool ok = f.read((uint8_t *)&header, sizeof(header)) == sizeof(header) && validHeader(header, dateYmd) &&
+            header.rowCount == rowCount;
+  ok = ok && f.seek(sizeof(header) + (uint32_t)rowCount * sizeof(CompetitionRow)) &&
+       f.read((uint8_t *)&crc, sizeof(crc)) == sizeof(crc);
+  f.close();
+  return ok;
+}
+
+class SegmentVisitor {
+public:
+  virtual ~SegmentVisitor() {}
+  virtual void onRow(uint16_t index, const CompetitionRow &row) = 0;
+};
+
+// Streams every row of a day's segment to `visitor`, then checks the CRC.
+// False for a missing, foreign or corrupt segment; anything visited must then
+// be discarded. A segment lost between the remove and the rename in
+// SegmentWriter::end() is read from its temp file and moved into place.
+bool scanSegment(const char *dateYmd, SegmentVisitor &visitor, uint16_t &rowCount) {
+  rowCount = 0;
+  const String segment = segmentPath(dateYmd);
+  const String tmpPath = segment + ".tmp";
+  const bool fromTmp = !SPIFFS.exists(segment);
+  const String path = fromTmp ? tmpPath : segment;
+  if (!SPIFFS.exists(path)) return false;
+  File f = SPIFFS.open(path, "r");
+  if (!f) return false;
+
+  SegmentHeader header;
+  bool ok = f.read((uint8_t *)&header, sizeof(header)) == sizeof(header);
+  ok = ok && validHeader(header, dateYmd);
+
+  uint32_t crc = 0;
+  CompetitionRow row;
+  for (uint16_t i = 0; ok && i < header.rowCount; ++i) {
+    ok = f.read((uint8_t *)&row, sizeof(row)) == sizeof(row);
+    if (!ok) break;
+    crc = crc32_le(crc, (const uint8_t *)&row, sizeof(row));
+    visitor.onRow(i, row);
+  }
+  uint32_t stored = 0;
+  ok = ok && f.read((uint8_t *)&stored, sizeof(stored)) == sizeof(stored);
+  f.close();
+  if (!ok) return false;
+  if (stored != crc) {
+    Serial.printf("SCHED: %s failed CRC\n", path.c_str());
+    return false;
+  }
+  if (fromTmp && SPIFFS.rename(tmpPath, segment)) Serial.printf("SCHED: recovered %s\n", segment.c_str());
+  rowCount = header.rowCount;
+  return true;
+}
+
+class PageVisitor : public SegmentVisitor {
+public:
+  PageVisitor(DailyScheduleState &out, uint16_t firstRow) : _out(out), _firstRow(firstRow) {}
+
+  void onRow(uint16_t index, const CompetitionRow &row) override {
+    if (index >= _firstRow && _out.rowCount < kMaxScheduleRows) _out.rows[_out.rowCount++] = row;
+  }
+
+private:
+  DailyScheduleState &_out;
+  uint16_t _firstRow;
+};
+
+class NextMedalVisitor : public SegmentVisitor {
+public:
+  explicit NextMedalVisitor(time_t now) : _now(now) {}
+
+  void onRow(uint16_t, const CompetitionRow &row) override {
+    if (found || !row.isMedalSession || row.status == EventStatus::FINAL || row.startEpoch < _now) return;
+    match = row;
+    found = true;
+  }
+
+  bool found = false;
+  CompetitionRow match;
+
+private:
+  time_t _now;
+};
+
+}  // namespace
+
+namespace ScheduleCache {
+
+bool SegmentWriter::begin(const char *dateYmd, uint16_t rowCount, uint32_t rowsCrc) {
+  _path = segmentPath(dateYmd);
+  uint32_t stored = 0;
+  if (storedCrc(_path, dateYmd, rowCount, stored) && stored == rowsCrc) return false;
+
+  _rowCount = rowCount;
+  _written = 0;
+  _crc = 0;
+  SegmentHeader header = {};
+  header.magic = kSegmentMagic;
+  header.version = kSegmentVersion;
+  header.rowSize = sizeof(CompetitionRow);
+  header.rowCount = rowCount;
+  strlcpy(header.dateYmd, dateYmd, sizeof(header.dateYmd));
+
+  _file = SPIFFS.open(_path + ".tmp", "w");
+  _ok = _file && _file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+  return true;
+}
+
+bool SegmentWriter::write(const CompetitionRow &row) {
+  if (!_ok) return false;
+  _crc = crc32_le(_crc, (const uint8_t *)&row, sizeof(row));
+  _ok = _file.write((const uint8_t *)&row, sizeof(row)) == sizeof(row);
+  _written++;
+  return _ok;
+}
+
+bool SegmentWriter::end(bool complete) {
+  const String tmpPath = _path + ".tmp";
+  bool ok = _ok && complete && _written == _rowCount;
+  ok = ok && _file.write((const uint8_t *)&_crc, sizeof(_crc)) == sizeof(_crc);
+  if (_file) _file.close();
+  if (!ok) {
+    SPIFFS.remove(tmpPath);
+    Serial.printf("SCHED: failed to write %s\n", _path.c_str());
+    return false;
+  }
+  SPIFFS.remove(_path);
+  if (!SPIFFS.rename(tmpPath, _path)) return false;
+
+  g_generation++;
+  return true;
+}
+
+bool loadPage(const char *dateYmd, uint16_t firstRow, DailyScheduleState &out) {
+  static DailyScheduleState page;
+  page = DailyScheduleState();
+  PageVisitor visitor(page, firstRow);
+  uint16_t total = 0;
+  if (!scanSegment(dateYmd, visitor, total)) return false;
+  page.valid = true;
+  strlcpy(page.dateYmd, dateYmd, sizeof(page.dateYmd));
+  page.firstRow = firstRow;
+  page.totalRows = total;
+  out = page;
+  return true;
+}
+
+bool findNextMedal(const String *days, uint8_t dayCount, time_t now, CompetitionRow &out) {
+  for (uint8_t i = 0; i < dayCount; ++i) {
+    NextMedalVisitor visitor(now);
+    uint16_t total = 0;
+    if (scanSegment(days[i].c_str(), visitor, total) && visitor.found) {
+      out = visitor.match;
+      return true;
+    }
+  }
+  return false;
+}
+
+void prune(const char *oldestYmd) {
+  // Segment names are the compact date, so they sort like the dates do.
+  const String oldest = segmentPath(oldestYmd).substring(strlen(kSegmentDir) + 1, strlen(kSegmentDir) + 9);
+  String doomed[kMaxPrunePerCall];
+  uint8_t count = 0;
+  File dir = SPIFFS.open(kSegmentDir);
+  if (!dir || !dir.isDirectory()) return;
+  for (File f = dir.openNextFile(); f && count < kMaxPrunePerCall; f = dir.openNextFile()) {
+    const String name = f.name();
+    // A temp file is a leftover only beside its segment; alone it may be the
+    // sole copy, which scanSegment() recovers.
+    const bool staleTmp =
+        name.endsWith(".tmp") && SPIFFS.exists(String(kSegmentDir) + "/" + name.substring(0, name.length() - 4));
+    if (staleTmp || name.substring(0, 8) < oldest) {
+      doomed[count++] = String(kSegmentDir) + "/" + name;
+    }
+  }
+  dir.close();
+  for (uint8_t i = 0; i < count; ++i) {
+    SPIFFS.remove(doomed[i]);
+    Serial.printf("SCHED: pruned %s\n", doomed[i].c_str());
+  }
+}
+
+uint32_t generation() {
+  return g_generation;
+}
+
+}  // namespace ScheduleCache
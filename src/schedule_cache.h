@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "olympic_scoreboard_client.h"
+
+// Rolling per-day schedule in SPIFFS: one segment per date under /sched with
+// every row of that day sorted by start time (up to kMaxDayRows). Segments
+// are written while the schedule is fetched and paged back into RAM on
+// demand, so day rollover and cross-day lookups need no request.
+// Segments are CRC-checked on every read.
+
+namespace ScheduleCache {
+
+// Days after today that the network task keeps cached.
+static const uint8_t kDaysAhead = 2;
+
+// Streams one fetched day into its segment, via a temp file that replaces the
+// old segment only when complete. A day whose rows match the stored segment's
+// CRC is skipped to spare the flash; any change is written at once, so paged-in
+// rows are never older than the last fetch.
+class SegmentWriter : public ScheduleRowSink {
+public:
+  bool begin(const char *dateYmd, uint16_t rowCount, uint32_t rowsCrc) override;
+  bool write(const CompetitionRow &row) override;
+  bool end(bool complete) override;
+
+private:
+  File _file;
+  String _path;
+  uint32_t _crc = 0;
+  uint16_t _rowCount = 0;
+  uint16_t _written = 0;
+  bool _ok = false;
+};
+
+// Loads rows [firstRow, firstRow + kMaxScheduleRows) of a cached day.
+bool loadPage(const char *dateYmd, uint16_t firstRow, DailyScheduleState &out);
+
+// First medal session starting at or after `now`, searching `days` in order.
+bool findNextMedal(const String *days, uint8_t dayCount, time_t now, CompetitionRow &out);
+
+// Removes segments (and stray temp files) for dates before `oldestYmd`.
+void prune(const char *oldestYmd);
+
+// Bumped on every segment write, so callers know when to redo lookups.
+uint32_t generation();
+
+}  // namespace ScheduleCache
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <type_traits>
+
+// Single-writer handoff of a plain-data state between FreeRTOS tasks.
+// The writer fills the back buffer and then bumps a sequence number whose low
+// bit selects the front buffer; readers copy the front buffer and retry if
+// the sequence moved underneath them (a seqlock over a double buffer).
+// Neither side ever blocks the other.
+template <typename T>
+class SnapshotBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "SnapshotBuffer needs plain data");
+
+public:
+  // Writer side; only one task may publish.
+  void publish(const T &value) {
+    const uint32_t next = _seq.load(std::memory_order_relaxed) + 1;
+    memcpy(&_buf[next & 1U], &value, sizeof(T));
+    _seq.store(next, std::memory_order_release);
+  }
+
+  // Copies the latest snapshot into `out` if it is newer than `seenSeq`.
+  bool readIfNewer(T &out, uint32_t &seenSeq) const {
+    for (;;) {
+      const uint32_t seq = _seq.load(std::memory_order_acquire);
+      if (seq == seenSeq) return false;
+      memcpy(&out, &_buf[seq & 1U], sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (_seq.load(std::memory_order_relaxed) == seq) {
+        seenSeq = seq;
+        return true;
+      }
+    }
+  }
+
+  bool hasValue() const { return _seq.load(std::memory_order_acquire) != 0; }
+
+private:
+  T _buf[2];
+  std::atomic<uint32_t> _seq{0};
+};
@@ -0,0 +1,229 @@
+#include "state_store.h"
+
+#include <SPIFFS.h>
+#include <rom/crc.h>
+
+namespace {
+
+static const uint32_t kRecordMagic = 0x3142534F;  // "OSB1"
+static const uint16_t kRecordVersion = 1;
+static const uint16_t kKindMedals = 1;
+static const uint16_t kKindSchedule = 2;
+
+static const uint32_t kMedalsMinWriteMs = 5UL * 60UL * 1000UL;
+static const uint32_t kScheduleMinWriteMs = 15UL * 60UL * 1000UL;
+
+// On-flash layout: header, then a small per-kind meta block, then only the
+// rows in use. Row and meta sizes are recorded so a firmware with a different
+// struct layout rejects the file instead of misreading it.
+struct RecordHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t kind;
+  uint16_t metaSize;
+  uint16_t rowSize;
+  uint8_t rowCount;
+  uint8_t reserved[3];
+  uint32_t crc;
+};
+
+struct MedalsMeta {
+  uint8_t favoriteCount;
+  FavoriteStanding favorites[kMaxFavorites];
+};
+
+struct ScheduleMeta {
+  char dateYmd[sizeof(DailyScheduleState::dateYmd)];
+  uint8_t reserved;
+  uint16_t firstRow;
+  uint16_t totalRows;
+};
+
+struct FileSlot {
+  const char *path;
+  uint16_t kind;
+  uint32_t minWriteMs;
+  uint32_t crc;
+  uint32_t lastWriteMs;
+  bool crcKnown;
+  bool pending;
+};
+
+FileSlot g_medalsFile = {"/state/medals.bin", kKindMedals, kMedalsMinWriteMs, 0, 0, false, false};
+FileSlot g_scheduleFile = {"/state/schedule.bin", kKindSchedule, kScheduleMinWriteMs, 0, 0, false, false};
+
+uint32_t recordCrc(const void *meta, uint16_t metaSize, const void *rows, size_t rowBytes) {
+  uint32_t crc = crc32_le(0, (const uint8_t *)meta, metaSize);
+  return crc32_le(crc, (const uint8_t *)rows, (uint32_t)rowBytes);
+}
+
+bool writeRecord(const FileSlot &slot,
+                 const void *meta,
+                 uint16_t metaSize,
+                 const void *rows,
+                 uint16_t rowSize,
+                 uint8_t rowCount,
+                 uint32_t crc) {
+  RecordHeader header = {};
+  header.magic = kRecordMagic;
+  header.version = kRecordVersion;
+  header.kind = slot.kind;
+  header.metaSize = metaSize;
+  header.rowSize = rowSize;
+  header.rowCount = rowCount;
+  header.crc = crc;
+
+  // Write beside the live file and swap, so a power cut mid-write leaves the
+  // previous snapshot intact. A cut between the remove and the rename leaves
+  // only the finished temp file, which readRecord() picks up.
+  const String tmpPath = String(slot.path) + ".tmp";
+  File f = SPIFFS.open(tmpPath, "w");
+  if (!f) return false;
+  const size_t rowBytes = (size_t)rowSize * rowCount;
+  bool ok = f.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+  ok = ok && f.write((const uint8_t *)meta, metaSize) == metaSize;
+  ok = ok && (rowBytes == 0 || f.write((const uint8_t *)rows, rowBytes) == rowBytes);
+  f.close();
+  if (!ok) {
+    SPIFFS.remove(tmpPath);
+    return false;
+  }
+  SPIFFS.remove(slot.path);
+  return SPIFFS.rename(tmpPath, slot.path);
+}
+
+bool readRecord(FileSlot &slot,
+                void *meta,
+                uint16_t metaSize,
+                void *rows,
+                uint16_t rowSize,
+                uint8_t maxRows,
+                uint8_t &rowCount) {
+  rowCount = 0;
+  const String tmpPath = String(slot.path) + ".tmp";
+  const bool fromTmp = !SPIFFS.exists(slot.path);
+  const String path = fromTmp ? tmpPath : String(slot.path);
+  if (!SPIFFS.exists(path)) return false;
+  File f = SPIFFS.open(path, "r");
+  if (!f) return false;
+
+  RecordHeader header;
+  bool ok = f.read((uint8_t *)&header, sizeof(header)) == sizeof(header);
+  ok = ok && header.magic == kRecordMagic && header.version == kRecordVersion &&
+       header.kind == slot.kind && header.metaSize == metaSize && header.rowSize == rowSize &&
+       header.rowCount <= maxRows;
+  const size_t rowBytes = ok ? (size_t)rowSize * header.rowCount : 0;
+  ok = ok && f.read((uint8_t *)meta, metaSize) == metaSize;
+  ok = ok && (rowBytes == 0 || f.read((uint8_t *)rows, rowBytes) == rowBytes);
+  f.close();
+  if (!ok) return false;
+
+  if (recordCrc(meta, metaSize, rows, rowBytes) != header.crc) {
+    Serial.printf("STATE: %s failed CRC\n", path.c_str());
+    return false;
+  }
+  if (fromTmp && SPIFFS.rename(tmpPath, slot.path)) Serial.printf("STATE: recovered %s\n", slot.path);
+  rowCount = header.rowCount;
+  slot.crc = header.crc;
+  slot.crcKnown = true;
+  return true;
+}
+
+void saveRecord(FileSlot &slot,
+                const void *meta,
+                uint16_t metaSize,
+                const void *rows,
+                uint16_t rowSize,
+                uint8_t rowCount,
+                uint32_t nowMs) {
+  const uint32_t crc = recordCrc(meta, metaSize, rows, (size_t)rowSize * rowCount);
+  if (slot.crcKnown && slot.crc == crc) {
+    slot.pending = false;
+    return;
+  }
+  if (slot.lastWriteMs != 0 && nowMs - slot.lastWriteMs < slot.minWriteMs) {
+    slot.pending = true;
+    return;
+  }
+
+  slot.lastWriteMs = nowMs;
+  slot.pending = false;
+  if (writeRecord(slot, meta, metaSize, rows, rowSize, rowCount, crc)) {
+    slot.crc = crc;
+    slot.crcKnown = true;
+  } else {
+    Serial.printf("STATE: failed to write %s\n", slot.path);
+  }
+}
+
+}  // namespace
+
+namespace StateStore {
+
+bool loadMedals(MedalTableState &out) {
+  MedalTableState loaded;
+  MedalsMeta meta;
+  uint8_t rowCount = 0;
+  if (!readRecord(g_medalsFile, &meta, sizeof(meta), loaded.rows, sizeof(MedalRow), kMaxMedalRows, rowCount)) {
+    return false;
+  }
+  loaded.valid = true;
+  loaded.rowCount = rowCount;
+  loaded.favoriteCount = min<uint8_t>(meta.favoriteCount, kMaxFavorites);
+  memcpy(loaded.favorites, meta.favorites, sizeof(loaded.favorites));
+  out = loaded;
+  return true;
+}
+
+bool loadSchedule(DailyScheduleState &out) {
+  DailyScheduleState loaded;
+  ScheduleMeta meta;
+  uint8_t rowCount = 0;
+  if (!readRecord(g_scheduleFile,
+                  &meta,
+                  sizeof(meta),
+                  loaded.rows,
+                  sizeof(CompetitionRow),
+                  kMaxScheduleRows,
+                  rowCount)) {
+    return false;
+  }
+  loaded.valid = true;
+  loaded.rowCount = rowCount;
+  memcpy(loaded.dateYmd, meta.dateYmd, sizeof(loaded.dateYmd));
+  loaded.dateYmd[sizeof(loaded.dateYmd) - 1] = '\0';
+  loaded.firstRow = meta.firstRow;
+  loaded.totalRows = meta.totalRows;
+  out = loaded;
+  return true;
+}
+
+void saveMedals(const MedalTableState &state, uint32_t nowMs) {
+  if (!state.valid) return;
+  // Zeroed with padding included, so equal tables write equal bytes.
+  MedalsMeta meta;
+  memset(static_cast<void *>(&meta), 0, sizeof(meta));
+  meta.favoriteCount = state.favoriteCount;
+  memcpy(meta.favorites, state.favorites, sizeof(meta.favorites));
+  saveRecord(g_medalsFile, &meta, sizeof(meta), state.rows, sizeof(MedalRow), state.rowCount, nowMs);
+}
+
+void saveSchedule(const DailyScheduleState &state, uint32_t nowMs) {
+  if (!state.valid) return;
+  ScheduleMeta meta = {};
+  memcpy(meta.dateYmd, state.dateYmd, sizeof(meta.dateYmd));
+  meta.firstRow = state.firstRow;
+  meta.totalRows = state.totalRows;
+  saveRecord(g_scheduleFile, &meta, sizeof(meta), state.rows, sizeof(CompetitionRow), state.rowCount, nowMs);
+}
+
+void flushPending(const MedalTableState &medals, const DailyScheduleState &schedule, uint32_t nowMs) {
+  if (g_medalsFile.pending && nowMs - g_medalsFile.lastWriteMs >= g_medalsFile.minWriteMs) {
+    saveMedals(medals, nowMs);
+  }
+  if (g_scheduleFile.pending && nowMs - g_scheduleFile.lastWriteMs >= g_scheduleFile.minWriteMs) {
+    saveSchedule(schedule, nowMs);
+  }
+}
+
+}  // namespace StateStore
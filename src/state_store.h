@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "olympic_scoreboard_client.h"
+
+// Last-known medal table and schedule kept in SPIFFS so the first frame after
+// power-on can show real (stale-flagged) data before Wi-Fi is up.
+// Records are versioned and CRC-checked; writes are skipped when the content
+// is unchanged and throttled so a busy schedule cannot wear the flash.
+
+namespace StateStore {
+
+// Call after SPIFFS is mounted (Assets::begin()).
+bool loadMedals(MedalTableState &out);
+bool loadSchedule(DailyScheduleState &out);
+
+// Record a new state. It is written immediately unless the same content is
+// already on flash or the per-file write interval has not elapsed, in which
+// case flushPending() writes it later.
+void saveMedals(const MedalTableState &state, uint32_t nowMs);
+void saveSchedule(const DailyScheduleState &state, uint32_t nowMs);
+
+// Call periodically with the current states to complete throttled writes.
+void flushPending(const MedalTableState &medals, const DailyScheduleState &schedule, uint32_t nowMs);
+
+}  // namespace StateStore
@@ -4,11 +4,15 @@
 Usage (PowerShell):
   python tools/fetch_flags.py
   python tools/fetch_flags.py --competition OWG2026 --out data/flags
+  python tools/fetch_flags.py --atlas flags_atlas.bin
 
 Notes:
 - Source URLs may be PNG/JPEG/GIF depending on country.
 - If Pillow is installed, non-PNG inputs are converted to PNG.
 - Without Pillow, non-PNG images are skipped.
+- With Pillow, the flags are also rasterized to raw RGB565 at the sizes the
+  UI draws and packed into an atlas for the `flags` partition (see
+  src/flag_atlas.h for the layout).
 """
 
 from __future__ import annotations
@@ -18,15 +22,22 @@ import io
 import json
 import os
 import shutil
+import struct
 import sys
 import urllib.error
 import urllib.request
-from typing import Dict, Optional
+from typing import Dict, List, Optional, Tuple
 
 MEDALS_URL = "https://sdf.nbcolympics.com/v1/widget/medals/country?competitionCode={competition}"
 MEDALS_AUTH_HEADER = "daaacddd-1513-46a3-8b79-ac3584258f5b"
 DEFAULT_COMPETITION = "OWG2026"
 SIZES = (56, 64, 96)
+# Medal table rows and the alert popup.
+ATLAS_SIZES = (12, 72)
+ATLAS_MAGIC = 0x47414C46  # "FLAG"
+ATLAS_VERSION = 1
+# Size of the `flags` partition in partitions_spiffs_flags.csv.
+ATLAS_MAX_BYTES = 0xC0000
 
 try:
     from PIL import Image
@@ -104,6 +115,76 @@ def save_resized_png(data: bytes, path: str, target_w: int) -> bool:
     return True
 
 
+def rasterize_rgb565(data: bytes, size: int) -> Optional[Tuple[int, int, bytes]]:
+    """Scale to fit a size x size box; pixels are big-endian RGB565."""
+    if not PIL_AVAILABLE:
+        return None
+    try:
+        with Image.open(io.BytesIO(data)) as img:
+            img = img.convert("RGBA")
+            src_w, src_h = img.size
+            if src_w <= 0 or src_h <= 0:
+                return None
+            scale = size / max(src_w, src_h)
+            w = max(1, int(round(src_w * scale)))
+            h = max(1, int(round(src_h * scale)))
+            resampling = Image.Resampling.LANCZOS if hasattr(Image, "Resampling") else Image.LANCZOS
+            img = img.resize((w, h), resample=resampling)
+            # Transparent pixels end up black, as PNGdec draws them.
+            flat = Image.new("RGBA", img.size, (0, 0, 0, 255))
+            flat.alpha_composite(img)
+            out = bytearray()
+            for r, g, b, _ in flat.getdata():
+                out += struct.pack(">H", ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+            return w, h, bytes(out)
+    except Exception:  # noqa: BLE001
+        return None
+
+
+def pack_atlas(tiles: List[Tuple[str, int, int, int, bytes]]) -> bytes:
+    """Header, entries sorted by (code, size), then 4-byte aligned pixels."""
+    tiles = sorted(tiles, key=lambda t: (t[0].encode("ascii").ljust(4, b"\0"), t[1]))
+    header_size = 12 + 16 * len(tiles)
+    offset = (header_size + 3) & ~3
+    entries = bytearray()
+    pixels = bytearray()
+    for code, size, w, h, data in tiles:
+        entries += struct.pack("<4sHHHHI", code.encode("ascii"), size, w, h, 0, offset + len(pixels))
+        pixels += data
+        pixels += b"\0" * (-len(pixels) % 4)
+    body = bytes(entries) + b"\0" * (offset - header_size) + bytes(pixels)
+    total = 12 + len(body)
+    return struct.pack("<IHHI", ATLAS_MAGIC, ATLAS_VERSION, len(tiles), total) + body
+
+
+def write_atlas(sources: Dict[str, bytes], path: str, max_bytes: int) -> bool:
+    if not PIL_AVAILABLE:
+        print("Pillow not found: flag atlas skipped")
+        return False
+
+    tiles = []
+    for abbr in sorted(sources):
+        if len(abbr) > 4:
+            continue
+        for size in ATLAS_SIZES:
+            raster = rasterize_rgb565(sources[abbr], size)
+            if raster:
+                tiles.append((abbr, size) + raster)
+
+    atlas = pack_atlas(tiles)
+    if len(atlas) > max_bytes:
+        print(f"Atlas is {len(atlas)} bytes, over the {max_bytes} byte partition; not written")
+        return False
+
+    out_dir = os.path.dirname(path)
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+    with open(path, "wb") as f:
+        f.write(atlas)
+    print(f"Wrote {len(tiles)} atlas tiles ({len(atlas)} bytes) to {path}")
+    return True
+
+
 def collect_flags(rows: list[dict]) -> Dict[str, str]:
     out: Dict[str, str] = {}
     for row in rows:
@@ -119,6 +200,8 @@ def main() -> int:
     parser = argparse.ArgumentParser(description="Fetch Olympics medal flags into data/flags")
     parser.add_argument("--competition", default=DEFAULT_COMPETITION, help="competition code, e.g. OWG2026")
     parser.add_argument("--out", default=os.path.join("data", "flags"), help="output root folder")
+    parser.add_argument("--atlas", default="flags_atlas.bin", help="RGB565 atlas for the flags partition ('' to skip)")
+    parser.add_argument("--atlas-max-bytes", type=lambda v: int(v, 0), default=ATLAS_MAX_BYTES, help="flags partition size")
     args = parser.parse_args()
 
     url = MEDALS_URL.format(competition=args.competition)
@@ -144,12 +227,14 @@ def main() -> int:
         print("Pillow not found: non-PNG source images will be skipped")
 
     ok_count = 0
+    sources: Dict[str, bytes] = {}
     for abbr in sorted(flags):
         base_url = flags[abbr]
         print(f"- {abbr}")
         base_bytes = download_bytes(base_url)
         if not base_bytes:
             continue
+        sources[abbr] = base_bytes
 
         for size in SIZES:
             out_path = os.path.join(args.out, str(size), f"{abbr}.png")
@@ -166,6 +251,8 @@ def main() -> int:
 
     print(f"Done. Downloaded {ok_count} sized PNG files into {args.out}")
     print("Upload to SPIFFS with: pio run -e esp32-cyd-sdfix -t uploadfs")
+    if args.atlas and write_atlas(sources, args.atlas, args.atlas_max_bytes):
+        print(f"Flash the atlas with: pio pkg exec -p tool-esptoolpy -- esptool.py --chip esp32 write_flash 0x340000 {args.atlas}")
     return 0
 
 
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Write JSON feed fixtures for the native bench/runner (see native/shims/HTTPClient.h).
+
+Usage (PowerShell):
+  python tools/make_bench_fixtures.py
+  python tools/make_bench_fixtures.py --set large --countries 220 --events 320
+  python tools/make_bench_fixtures.py --record --date 2026-02-10
+
+Synthetic sets mirror the shape of the NBC feeds, including the fields the
+firmware ignores, so filter and truncation costs show up. --record captures the
+live medals-country, per-sport and schedule responses into fixtures/recorded.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import random
+import sys
+import urllib.request
+
+COMPETITION = "OWG2026"
+MEDALS_COUNTRY_URL = f"https://sdf.nbcolympics.com/v1/widget/medals/country?competitionCode={COMPETITION}"
+MEDALS_SPORT_URL = f"https://sdf.nbcolympics.com/v1/widget/medals/sport?competitionCode={COMPETITION}&sportCode={{code}}"
+SCHEDULE_URL = "https://schedules.nbcolympics.com/api/v1/schedule?startDate={date}"
+MEDALS_AUTH_HEADER = "daaacddd-1513-46a3-8b79-ac3584258f5b"
+
+SPORTS = [
+    ("ALP", "Alpine Skiing"),
+    ("BTH", "Biathlon"),
+    ("BOB", "Bobsled"),
+    ("CCS", "Cross-Country Skiing"),
+    ("CUR", "Curling"),
+    ("FSK", "Figure Skating"),
+    ("FRS", "Freestyle Skiing"),
+    ("IHO", "Hockey"),
+    ("LUG", "Luge"),
+    ("NCB", "Nordic Combined"),
+    ("SBD", "Snowboarding"),
+    ("SKN", "Skeleton"),
+    ("SJP", "Ski Jumping"),
+    ("SMT", "Ski Mountaineering"),
+    ("SSK", "Speed Skating"),
+    ("STK", "Short Track"),
+]
+
+PRESETS = {
+    "small": (30, 40),
+    "large": (220, 320),
+}
+
+
+def fixture_name(url: str) -> str:
+    # Must match NativeHttp::fixtureName().
+    name = url.split("://", 1)[-1]
+    return "".join(c if c.isalnum() or c in ".-" else "_" for c in name) + ".json"
+
+
+def write_fixture(out_dir: str, url: str, payload: bytes) -> None:
+    os.makedirs(out_dir, exist_ok=True)
+    path = os.path.join(out_dir, fixture_name(url))
+    with open(path, "wb") as f:
+        f.write(payload)
+    print(f"  {len(payload):>8} B  {path}")
+
+
+def country_codes(count: int) -> list[str]:
+    codes = ["NOR", "GER", "USA", "CAN", "NED", "SWE", "ITA", "AUT", "SUI", "FRA", "JPN", "KOR", "CHN"]
+    n = 0
+    while len(codes) < count:
+        code = chr(ord("A") + n // 676 % 26) + chr(ord("A") + n // 26 % 26) + chr(ord("A") + n % 26)
+        if code not in codes:
+            codes.append(code)
+        n += 1
+    return codes[:count]
+
+
+def medal_row(rank: int, code: str, gold: int, silver: int, bronze: int) -> dict:
+    return {
+        "countryCode": code,
+        "countryName": f"Country {code}",
+        "flagUrl": {
+            "small": f"https://images.nbcolympics.com/country-flags/38x25/{code.lower()}.png",
+            "medium": f"https://images.nbcolympics.com/country-flags/76x50/{code.lower()}.png",
+        },
+        "gold": gold,
+        "silver": silver,
+        "bronze": bronze,
+        "medalTotal": gold + silver + bronze,
+        "medalRank": rank,
+        "medalRankTotal": rank,
+        "links": {"country": f"https://www.nbcolympics.com/countries/{code.lower()}"},
+    }
+
+
+def medal_rows(codes: list[str], rng: random.Random, scale: int) -> list[dict]:
+    tallies = sorted(((rng.randint(0, scale), rng.randint(0, scale), rng.randint(0, scale), c) for c in codes), reverse=True)
+    return [medal_row(i + 1, c, g, s, b) for i, (g, s, b, c) in enumerate(tallies)]
+
+
+def schedule_item(rng: random.Random, base_epoch: int, index: int) -> dict:
+    code, name = SPORTS[rng.randrange(len(SPORTS))]
+    start = base_epoch + index * 180 + rng.randint(0, 120)
+    title = f"{name} {rng.choice(['Men', 'Women', 'Mixed'])} {rng.choice(['Heat', 'Qualifying', 'Final', 'Semifinal'])} {index}"
+    return {
+        "singleEvent": {
+            "id": f"evt-{index}",
+            "title": title,
+            "shortTitle": title[:40],
+            "startDate": start,
+            "endDate": start + 5400,
+            "status": rng.choice(["upcoming", "live", "final"]),
+            "isMedalSession": rng.random() < 0.2,
+            "gameType": "olympics",
+            "summary": "Coverage of " + title + ". " * 4,
+            "network": {"name": "Peacock", "logo": "https://example.invalid/peacock.png"},
+            "venue": {"name": "Cortina Olympic Stadium", "city": "Cortina d'Ampezzo"},
+        },
+        "sports": [{"code": code, "shortDisplayTitle": name, "title": name, "slug": name.lower().replace(" ", "-")}],
+        "images": [{"url": f"https://example.invalid/{index}.jpg", "width": 1280, "height": 720}],
+    }
+
+
+def make_synthetic(out_dir: str, countries: int, events: int, date: str, seed: int) -> None:
+    rng = random.Random(seed)
+    codes = country_codes(countries)
+    print(f"Synthetic set: {countries} countries, {events} schedule items -> {out_dir}")
+
+    write_fixture(out_dir, MEDALS_COUNTRY_URL, json.dumps(medal_rows(codes, rng, 12)).encode("utf-8"))
+    for code, _name in SPORTS:
+        rows = medal_rows(rng.sample(codes, min(len(codes), 25)), rng, 3)
+        write_fixture(out_dir, MEDALS_SPORT_URL.format(code=code), json.dumps(rows).encode("utf-8"))
+
+    base_epoch = 1770714000  # 2026-02-10 09:00 UTC
+    items = [schedule_item(rng, base_epoch, i) for i in range(events)]
+    write_fixture(out_dir, SCHEDULE_URL.format(date=date), json.dumps({"data": items}).encode("utf-8"))
+
+
+def fetch_bytes(url: str, auth: bool) -> bytes:
+    headers = {"User-Agent": "bench-recorder/1.0", "Accept": "application/json"}
+    if auth:
+        headers["x-olyapiauth"] = MEDALS_AUTH_HEADER
+    with urllib.request.urlopen(urllib.request.Request(url, headers=headers), timeout=30) as resp:
+        return resp.read()
+
+
+def record(out_dir: str, date: str) -> int:
+    print(f"Recording live feeds -> {out_dir}")
+    try:
+        write_fixture(out_dir, MEDALS_COUNTRY_URL, fetch_bytes(MEDALS_COUNTRY_URL, True))
+        for code, _name in SPORTS:
+            url = MEDALS_SPORT_URL.format(code=code)
+            write_fixture(out_dir, url, fetch_bytes(url, True))
+        url = SCHEDULE_URL.format(date=date)
+        write_fixture(out_dir, url, fetch_bytes(url, False))
+    except Exception as exc:  # noqa: BLE001
+        print(f"Failed to record feeds: {exc}")
+        return 1
+    return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Write JSON feed fixtures for the native bench")
+    parser.add_argument("--out", default="fixtures", help="fixtures root folder")
+    parser.add_argument("--set", choices=sorted(PRESETS), help="only write this synthetic preset")
+    parser.add_argument("--countries", type=int, help="override the preset's country count")
+    parser.add_argument("--events", type=int, help="override the preset's schedule item count")
+    parser.add_argument("--date", default="2026-02-10", help="schedule date, YYYY-MM-DD")
+    parser.add_argument("--seed", type=int, default=2026, help="random seed for synthetic data")
+    parser.add_argument("--record", action="store_true", help="capture the live feeds instead")
+    args = parser.parse_args()
+
+    if args.record:
+        return record(os.path.join(args.out, "recorded"), args.date)
+
+    for name in [args.set] if args.set else sorted(PRESETS):
+        countries, events = PRESETS[name]
+        make_synthetic(
+            os.path.join(args.out, name),
+            args.countries or countries,
+            args.events or events,
+            args.date,
+            args.seed,
+        )
+    print("Run with: pio run -e native_bench && .pio/build/native_bench/program")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())